@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+  * @file           : BVH.cpp
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-2
+  ******************************************************************************
+  */
+
+
+
+#include <Acceleration/BVH.h>
+#include <Entity.h>
+
+CONSTEXPR int BINS = 16;
+
+NODISCARD static float Area(const glm::vec3& vmin, const glm::vec3& vmax) NOEXCEPT
+{
+  const glm::vec3 d = vmax - vmin;
+  return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+void BVH::Build(BVH& bvh, const AABB* aabbs, const uint32_t count, const uint32_t leaf_size) NOEXCEPT
+{
+  ASSERT(leaf_size > 0);
+
+  bvh.nodes.clear();
+  bvh.items.resize(count);
+  std::iota(bvh.items.begin(), bvh.items.end(), 0u);
+
+  if (count == 0)
+  {
+    return;
+  }
+
+  static std::vector<glm::vec3> centers;
+  centers.resize(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    centers[i] = AABB::Center(aabbs[i]);
+  }
+
+  struct Bin
+  {
+    glm::vec3 vmin = glm::vec3(INF);
+    glm::vec3 vmax = glm::vec3(-INF);
+    uint32_t count = {};
+  };
+
+  // COMMENT: Items [first, first + count) Still To Be Turned Into A Node. The Right Child Links Itself Into parent When It Is Emitted.
+  struct Range
+  {
+    uint32_t first;
+    uint32_t count;
+    uint32_t parent;
+    bool right;
+  };
+
+  std::vector<Range> stack = { Range{ 0, count, 0, false } };
+  while (!stack.empty())
+  {
+    const Range range = stack.back();
+    stack.pop_back();
+
+    const uint32_t id = (uint32_t)bvh.nodes.size();
+    if (range.right)
+    {
+      bvh.nodes[range.parent].index = id;
+    }
+
+    uint32_t* items = bvh.items.data() + range.first;
+
+    Node node;
+    node.vmin = glm::vec3(INF), node.vmax = glm::vec3(-INF);
+    glm::vec3 cmin(INF), cmax(-INF);
+    for (uint32_t i = 0; i < range.count; ++i)
+    {
+      node.vmin = glm::min(node.vmin, aabbs[items[i]].vmin);
+      node.vmax = glm::max(node.vmax, aabbs[items[i]].vmax);
+      cmin = glm::min(cmin, centers[items[i]]);
+      cmax = glm::max(cmax, centers[items[i]]);
+    }
+
+    if (range.count <= leaf_size)
+    {
+      node.index = range.first;
+      node.count = range.count;
+      bvh.nodes.emplace_back(node);
+      continue;
+    }
+
+    // COMMENT: Bin Centers Along Each Axis And Sweep The Bin Boundaries. Cost Is Area(left) * |left| + Area(right) * |right|.
+    float best_cost = INF;
+    int best_axis = -1;
+    int best_bin = 0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      const float extent = cmax[axis] - cmin[axis];
+      if (extent <= 0.0f)
+      {
+        continue;
+      }
+      const float scale = (float)BINS / extent;
+
+      Bin bins[BINS];
+      for (uint32_t i = 0; i < range.count; ++i)
+      {
+        Bin& bin = bins[std::min((int)((centers[items[i]][axis] - cmin[axis]) * scale), BINS - 1)];
+        bin.vmin = glm::min(bin.vmin, aabbs[items[i]].vmin);
+        bin.vmax = glm::max(bin.vmax, aabbs[items[i]].vmax);
+        ++bin.count;
+      }
+
+      float right_area[BINS];
+      uint32_t right_count[BINS];
+      Bin right;
+      for (int b = BINS - 1; b > 0; --b)
+      {
+        right.vmin = glm::min(right.vmin, bins[b].vmin);
+        right.vmax = glm::max(right.vmax, bins[b].vmax);
+        right.count += bins[b].count;
+        right_area[b] = Area(right.vmin, right.vmax);
+        right_count[b] = right.count;
+      }
+
+      Bin left;
+      for (int b = 0; b < BINS - 1; ++b)
+      {
+        left.vmin = glm::min(left.vmin, bins[b].vmin);
+        left.vmax = glm::max(left.vmax, bins[b].vmax);
+        left.count += bins[b].count;
+        if (left.count == 0 || right_count[b + 1] == 0)
+        {
+          continue;
+        }
+        const float cost = Area(left.vmin, left.vmax) * (float)left.count + right_area[b + 1] * (float)right_count[b + 1];
+        if (cost < best_cost)
+        {
+          best_cost = cost, best_axis = axis, best_bin = b;
+        }
+      }
+    }
+
+    // NOTE: All Centers Coincide When No Axis Has Extent, So Any Split Is As Good As Another.
+    uint32_t mid = range.count / 2;
+    if (best_axis >= 0)
+    {
+      const float scale = (float)BINS / (cmax[best_axis] - cmin[best_axis]);
+      mid = (uint32_t)(std::partition(items, items + range.count, [&](const uint32_t item) NOEXCEPT -> bool {
+        return std::min((int)((centers[item][best_axis] - cmin[best_axis]) * scale), BINS - 1) <= best_bin;
+      }) - items);
+    }
+
+    node.count = 0;
+    bvh.nodes.emplace_back(node);
+    stack.emplace_back(Range{ range.first + mid, range.count - mid, id, true });
+    stack.emplace_back(Range{ range.first, mid, id, false });
+  }
+}
@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file           : BVH.h
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-2
+  ******************************************************************************
+  */
+
+
+
+#ifndef BVH_H
+#define BVH_H
+
+#include <Common.h>
+
+struct AABB;
+
+// COMMENT: Bounding Volume Hierarchy Over Boxes, Split Where The Binned Surface Area Heuristic Is Cheapest.
+// COMMENT: Nodes Are Stored Depth First, So The Left Child Of Node i Is Node i + 1. Node 0 Is The Root.
+struct BVH
+{
+  // NOTE: 32 Bytes, Two Nodes Per Cache Line.
+  struct Node
+  {
+    glm::vec3 vmin = {};
+    // NOTE: Right Child Of An Inner Node, Or First Slot In items Of A Leaf.
+    uint32_t index = {};
+    glm::vec3 vmax = {};
+    // NOTE: Number Of Boxes In A Leaf. Inner Nodes Have count 0.
+    uint32_t count = {};
+  };
+
+  std::vector<Node>     nodes = {};
+  std::vector<uint32_t> items = {};
+
+  // COMMENT: Rebuild Over aabbs[0, count), Reusing The Storage Of The Previous Build. Leaves Hold At Most leaf_size Boxes.
+   static void Build(BVH& bvh, const AABB* aabbs, uint32_t count, uint32_t leaf_size) NOEXCEPT;
+};
+
+static_assert(sizeof(BVH::Node) == 32);
+
+#endif //BVH_H
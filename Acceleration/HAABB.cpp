@@ -11,10 +11,19 @@
 
 
 #include <Acceleration/HAABB.h>
+#include <Parallel.h>
+#include <Profiler.h>
+
+// COMMENT: Items Per Chunk Of The Parallel Passes. Fewer Items Than This Are Not Worth Waking The Pool For.
+CONSTEXPR size_t CHUNK_SIZE = 4096;
+
+// COMMENT: The Morton Code Is Sorted 10 Bits At A Time, So Three Passes Cover All 30 Bits.
+CONSTEXPR int RADIX_BITS = 10;
+CONSTEXPR int RADIX_SIZE = 1 << RADIX_BITS;
 
 NODISCARD glm::vec2 HAABB::Center(const HAABB& haabb) NOEXCEPT
 {
-  return glm::vec2(haabb.vmin + haabb.vmax) / 2.0f; 
+  return glm::vec2(haabb.vmin + haabb.vmax) / 2.0f;
 }
 
 NODISCARD glm::vec2 HAABB::Radius(const HAABB& haabb) NOEXCEPT
@@ -22,49 +31,203 @@ NODISCARD glm::vec2 HAABB::Radius(const HAABB& haabb) NOEXCEPT
   return glm::vec2(haabb.vmax - haabb.vmin) / 2.0f;
 }
 
-NODISCARD std::vector<HAABB> HAABB::Build(const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT
+// COMMENT: Run task(begin, end, chunk) Over Contiguous Chunks Of [0, count) On The Thread Pool.
+static void ParallelChunks(const size_t count, const int chunks, const std::function<void(size_t begin, size_t end, int chunk)>& task) NOEXCEPT
 {
-  std::vector<HAABB> haabbs;
-  haabbs.resize(polygons.size() * 2);
-  for (size_t i = 0; i < polygons.size(); ++i)
+  ThreadPool::ParallelFor(chunks, [&](const int chunk, const int) NOEXCEPT {
+    PROFILE_SCOPE(Profiler::HAABB_BUILD);
+    task(count * chunk / chunks, count * (chunk + 1) / chunks, chunk);
+  });
+}
+
+// COMMENT: Spread The Low 10 Bits Of v So That Two Zero Bits Follow Each.
+NODISCARD static uint32_t Expand(uint32_t v) NOEXCEPT
+{
+  v = (v * 0x00010001u) & 0xFF0000FFu;
+  v = (v * 0x00000101u) & 0x0F00F00Fu;
+  v = (v * 0x00000011u) & 0xC30C30C3u;
+  v = (v * 0x00000005u) & 0x49249249u;
+  return v;
+}
+
+// COMMENT: Length Of The Common Prefix Of Sorted Keys i And j, Or -1 When j Is Out Of Range. Equal Codes Fall Back To The Positions, So Keys Stay Distinct.
+NODISCARD static int Delta(const std::vector<uint32_t>& codes, const int i, const int j) NOEXCEPT
+{
+  if (j < 0 || j >= (int)codes.size())
+  {
+    return -1;
+  }
+  if (codes[i] == codes[j])
   {
-    haabbs[polygons.size() + i].vmin = Vertex(INF);
-    haabbs[polygons.size() + i].vmax = Vertex(-INF);
-    haabbs[polygons.size() + i].l = 0;
-    haabbs[polygons.size() + i].r = 0;
-    haabbs[polygons.size() + i].pid = i;
-    for (const auto& vertex : polygons[i].vertices)
+    return 32 + __builtin_clz((uint32_t)i ^ (uint32_t)j);
+  }
+  return __builtin_clz(codes[i] ^ codes[j]);
+}
+
+// NOTE: Linear BVH After Karras, "Maximizing Parallelism In The Construction Of BVHs, Octrees, And k-d Trees". Every Pass Runs In Parallel Chunks.
+// NOTE: Internal Node i Of The Paper Lives At i + 1 And Leaf j At n + j, So The Root Is At 1 And 0 Still Means No Child.
+void HAABB::Build(std::vector<HAABB>& haabbs, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT
+{
+  // NOTE: Every Node Is Written Below, So Storage Left From The Last Build Is Not Cleared.
+  const size_t n = polygons.size();
+  haabbs.resize(n * 2);
+  if (n == 0)
+  {
+    return;
+  }
+
+  const int chunks = (int)std::min((n + CHUNK_SIZE - 1) / CHUNK_SIZE, (size_t)ThreadPool::Concurrency() * 4);
+
+  static std::vector<AABB>      boxes;     boxes.resize(n);
+  static std::vector<AABB>      bounds;    bounds.resize(chunks);
+  static std::vector<uint32_t>  codes;     codes.resize(n);
+  static std::vector<uint32_t>  order;     order.resize(n);
+  static std::vector<uint32_t>  codes_tmp; codes_tmp.resize(n);
+  static std::vector<uint32_t>  order_tmp; order_tmp.resize(n);
+  static std::vector<uint32_t>  histogram; histogram.resize((size_t)chunks * RADIX_SIZE);
+  static std::vector<uint32_t>  parents;   parents.resize(n * 2);
+  static std::vector<uint32_t>  visits;    visits.assign(n, 0);
+
+  // COMMENT: Polygon Boxes And The Bounds Of Their Centers, Reduced Per Chunk.
+  // NOTE: A Polygon Without Vertices Gets An Infinitely Far Point, Which Every Depth Query Culls.
+  ParallelChunks(n, chunks, [&](const size_t begin, const size_t end, const int chunk) NOEXCEPT {
+    AABB bound = { .vmin = Vertex(INF), .vmax = Vertex(-INF) };
+    for (size_t i = begin; i < end; ++i)
     {
-      haabbs[polygons.size() + i].vmin = glm::min(haabbs[polygons.size() + i].vmin, vertices[vertex]);  
-      haabbs[polygons.size() + i].vmax = glm::max(haabbs[polygons.size() + i].vmax, vertices[vertex]);
+      boxes[i] = polygons[i].vertices.empty() ? AABB{ .vmin = Vertex(0.0f, 0.0f, INF), .vmax = Vertex(0.0f, 0.0f, INF) } : AABB::From(vertices, polygons[i]);
+      const Vertex center = polygons[i].vertices.empty() ? Vertex(0.0f) : AABB::Center(boxes[i]);
+      bound.vmin = glm::min(bound.vmin, center);
+      bound.vmax = glm::max(bound.vmax, center);
     }
+    bounds[chunk] = bound;
+  });
+  AABB bound = bounds[0];
+  for (int chunk = 1; chunk < chunks; ++chunk)
+  {
+    bound.vmin = glm::min(bound.vmin, bounds[chunk].vmin);
+    bound.vmax = glm::max(bound.vmax, bounds[chunk].vmax);
   }
-  std::sort(haabbs.begin() + polygons.size(), haabbs.end(), [](const HAABB& lhs, const HAABB& rhs) NOEXCEPT -> bool {
-    return Center(lhs).x < Center(rhs).x;
+
+  // COMMENT: 30 Bit Morton Codes Of The Centers, 10 Bits Per Axis.
+  const Vector extent = bound.vmax - bound.vmin;
+  const Vector scale = Vector(extent.x > 0.0f ? 1023.0f / extent.x : 0.0f, extent.y > 0.0f ? 1023.0f / extent.y : 0.0f, extent.z > 0.0f ? 1023.0f / extent.z : 0.0f);
+  ParallelChunks(n, chunks, [&](const size_t begin, const size_t end, const int) NOEXCEPT {
+    for (size_t i = begin; i < end; ++i)
+    {
+      const Vertex center = polygons[i].vertices.empty() ? bound.vmin : AABB::Center(boxes[i]);
+      const Vector q = glm::clamp((center - bound.vmin) * scale, Vector(0.0f), Vector(1023.0f));
+      codes[i] = (Expand((uint32_t)q.x) << 2) | (Expand((uint32_t)q.y) << 1) | Expand((uint32_t)q.z);
+      order[i] = (uint32_t)i;
+    }
   });
-  for (size_t i = haabbs.size() - 1; i >= 2; --i)
+
+  // COMMENT: Least Significant Digit First Radix Sort. Each Pass Counts Digits Per Chunk, Then Scatters Every Chunk To Its Own Offsets, Which Keeps The Sort Stable.
+  for (int shift = 0; shift < 30; shift += RADIX_BITS)
   {
-    if (i % 2)
+    ParallelChunks(n, chunks, [&](const size_t begin, const size_t end, const int chunk) NOEXCEPT {
+      uint32_t* count = histogram.data() + (size_t)chunk * RADIX_SIZE;
+      std::fill_n(count, RADIX_SIZE, 0u);
+      for (size_t i = begin; i < end; ++i)
+      {
+        ++count[(codes[i] >> shift) & (RADIX_SIZE - 1)];
+      }
+    });
+    uint32_t offset = 0;
+    for (int digit = 0; digit < RADIX_SIZE; ++digit)
     {
-      haabbs[i >> 1].r = i;
+      for (int chunk = 0; chunk < chunks; ++chunk)
+      {
+        const uint32_t count = histogram[(size_t)chunk * RADIX_SIZE + digit];
+        histogram[(size_t)chunk * RADIX_SIZE + digit] = offset;
+        offset += count;
+      }
     }
-    else
+    ParallelChunks(n, chunks, [&](const size_t begin, const size_t end, const int chunk) NOEXCEPT {
+      uint32_t* offsets = histogram.data() + (size_t)chunk * RADIX_SIZE;
+      for (size_t i = begin; i < end; ++i)
+      {
+        const uint32_t slot = offsets[(codes[i] >> shift) & (RADIX_SIZE - 1)]++;
+        codes_tmp[slot] = codes[i];
+        order_tmp[slot] = order[i];
+      }
+    });
+    codes.swap(codes_tmp);
+    order.swap(order_tmp);
+  }
+
+  // COMMENT: Leaves In Morton Order.
+  ParallelChunks(n, chunks, [&](const size_t begin, const size_t end, const int) NOEXCEPT {
+    for (size_t j = begin; j < end; ++j)
+    {
+      HAABB& leaf = haabbs[n + j];
+      leaf.vmin = boxes[order[j]].vmin;
+      leaf.vmax = boxes[order[j]].vmax;
+      leaf.l = 0;
+      leaf.r = 0;
+      leaf.pid = order[j];
+    }
+  });
+  parents[1] = 0;
+
+  // COMMENT: Every Internal Node Finds Its Key Range And Split From The Common Prefixes Around It, Independently Of Every Other Node.
+  ParallelChunks(n - 1, chunks, [&](const size_t begin, const size_t end, const int) NOEXCEPT {
+    for (int i = (int)begin; i < (int)end; ++i)
     {
-      haabbs[i >> 1].l = i;
-      if (haabbs[i >> 1].r == 0)
+      const int d = Delta(codes, i, i + 1) - Delta(codes, i, i - 1) > 0 ? 1 : -1;
+
+      const int delta_min = Delta(codes, i, i - d);
+      int lmax = 2;
+      while (Delta(codes, i, i + lmax * d) > delta_min)
+      {
+        lmax <<= 1;
+      }
+      int l = 0;
+      for (int t = lmax >> 1; t >= 1; t >>= 1)
       {
-        haabbs[i >> 1].vmin = haabbs[i].vmin;
-        haabbs[i >> 1].vmax = haabbs[i].vmax;
-        haabbs[i >> 1].pid = polygons.size();
+        if (Delta(codes, i, i + (l + t) * d) > delta_min)
+        {
+          l += t;
+        }
       }
-      else
+      const int j = i + l * d;
+
+      const int delta_node = Delta(codes, i, j);
+      int s = 0;
+      for (int t = (l + 1) >> 1; ; t = (t + 1) >> 1)
       {
-        haabbs[i >> 1].vmin = glm::min(haabbs[i].vmin, haabbs[i + 1].vmin);
-        haabbs[i >> 1].vmax = glm::max(haabbs[i].vmax, haabbs[i + 1].vmax);
-        haabbs[i >> 1].pid = polygons.size();
+        if (Delta(codes, i, i + (s + t) * d) > delta_node)
+        {
+          s += t;
+        }
+        if (t == 1)
+        {
+          break;
+        }
       }
+      const int gamma = i + s * d + std::min(d, 0);
+
+      HAABB& node = haabbs[i + 1];
+      node.l = std::min(i, j) == gamma ? n + gamma : gamma + 1;
+      node.r = std::max(i, j) == gamma + 1 ? n + gamma + 1 : gamma + 2;
+      node.pid = n;
+      parents[node.l] = i + 1;
+      parents[node.r] = i + 1;
     }
-  }
+  });
 
-  return haabbs;
+  // COMMENT: Bounds Bottom Up. Each Leaf Climbs Toward The Root, And At Every Node Only The Second Child To Arrive Goes On, So Both Children Are Done.
+  ParallelChunks(n, chunks, [&](const size_t begin, const size_t end, const int) NOEXCEPT {
+    for (size_t j = begin; j < end; ++j)
+    {
+      for (uint32_t node = parents[n + j]; node != 0; node = parents[node])
+      {
+        if (std::atomic_ref<uint32_t>(visits[node]).fetch_add(1, std::memory_order_acq_rel) == 0)
+        {
+          break;
+        }
+        haabbs[node].vmin = glm::min(haabbs[haabbs[node].l].vmin, haabbs[haabbs[node].r].vmin);
+        haabbs[node].vmax = glm::max(haabbs[haabbs[node].l].vmax, haabbs[haabbs[node].r].vmax);
+      }
+    }
+  });
 }
@@ -27,7 +27,8 @@ struct HAABB
 
   NODISCARD  static glm::vec2 Radius(const HAABB& haabb) NOEXCEPT;
 
-  NODISCARD  static std::vector<HAABB> Build(const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT;
+  // COMMENT: Rebuild Over The Canvas Bounds Of polygons, Reusing The Storage Of haabbs. Node 1 Is The Root, Or haabbs Is Empty Without Polygons.
+   static void Build(std::vector<HAABB>& haabbs, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT;
 };
 
 #endif //HAABB_H
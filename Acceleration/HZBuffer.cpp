@@ -10,7 +10,270 @@
 
 
 
-#ifndef HZBUFFER_HPP
-#define HZBUFFER_HPP
+#include <Acceleration/HZBuffer.h>
 
-#endif //HZBUFFER_HPP
+HZBuffer::Statistic HZBuffer::statistic = {};
+
+// COMMENT: Recompute Texels [x0, x1] x [y0, y1] Of A Level From 2x2 Texels Of The Level Below. A Missing Last Row Or Column Repeats Its Neighbour.
+static void Reduce(HZBuffer& h_z_buffer, const int level, const int x0, const int x1, const int y0, const int y1) NOEXCEPT
+{
+  float* dst = HZBuffer::Level(h_z_buffer, level);
+  const int width = h_z_buffer.widths[level];
+  const int src_width = h_z_buffer.widths[level - 1];
+  const int src_height = h_z_buffer.heights[level - 1];
+
+  HZBuffer::statistic.rebuilt_texels += (uint64_t)(x1 - x0 + 1) * (uint64_t)(y1 - y0 + 1);
+
+  if (level == 1)
+  {
+    // NOTE: Level 0 Is The ZBuffer. Tiles Not Yet Written This Frame Are Cleared First.
+    const ZBuffer& z_buffer = *h_z_buffer.z_buffer;
+    ZBuffer::Touch(z_buffer, x0 << 1, std::min((x1 << 1) + 1, src_width - 1), y0 << 1, std::min((y1 << 1) + 1, src_height - 1));
+    for (int y = y0; y <= y1; ++y)
+    {
+      const float* row0 = z_buffer.buffer[y << 1];
+      const float* row1 = z_buffer.buffer[std::min((y << 1) + 1, src_height - 1)];
+      for (int x = x0; x <= x1; ++x)
+      {
+        const int c0 = x << 1;
+        const int c1 = std::min(c0 + 1, src_width - 1);
+        dst[y * width + x] = std::max(std::max(row0[c0], row0[c1]), std::max(row1[c0], row1[c1]));
+      }
+    }
+    return;
+  }
+
+  const float* src = HZBuffer::Level(h_z_buffer, level - 1);
+  for (int y = y0; y <= y1; ++y)
+  {
+    const float* row0 = src + (size_t)(y << 1) * src_width;
+    const float* row1 = src + (size_t)std::min((y << 1) + 1, src_height - 1) * src_width;
+    for (int x = x0; x <= x1; ++x)
+    {
+      const int c0 = x << 1;
+      const int c1 = std::min(c0 + 1, src_width - 1);
+      dst[y * width + x] = std::max(std::max(row0[c0], row0[c1]), std::max(row1[c0], row1[c1]));
+    }
+  }
+}
+
+// COMMENT: Rebuild Levels [1, last] Above A Pixel Rect.
+static void Propagate(HZBuffer& h_z_buffer, const int last, int xmin, int xmax, int ymin, int ymax) NOEXCEPT
+{
+  for (int level = 1; level <= last; ++level)
+  {
+    xmin >>= 1, xmax >>= 1, ymin >>= 1, ymax >>= 1;
+    Reduce(h_z_buffer, level, xmin, xmax, ymin, ymax);
+  }
+}
+
+NODISCARD HZBuffer HZBuffer::From(const Canvas& canvas) NOEXCEPT
+{
+  HZBuffer h_z_buffer;
+  h_z_buffer.z_buffer = canvas.z_buffer;
+  h_z_buffer.width = canvas.width;
+  h_z_buffer.height = canvas.height;
+
+  size_t size = 0;
+  for (int w = canvas.width, h = canvas.height; ; w = (w + 1) >> 1, h = (h + 1) >> 1)
+  {
+    h_z_buffer.widths.push_back(w);
+    h_z_buffer.heights.push_back(h);
+    h_z_buffer.offsets.push_back(size);
+    // NOTE: Level 0 Lives In The ZBuffer, So It Takes No Space Here.
+    if (h_z_buffer.widths.size() > 1)
+    {
+      size += (size_t)w * (size_t)h;
+    }
+    if (w <= 1 && h <= 1)
+    {
+      break;
+    }
+  }
+  h_z_buffer.levels = (int)h_z_buffer.widths.size();
+  h_z_buffer.data = new float[std::max(size, (size_t)1)];
+
+  // COMMENT: Dirty Texels Match The Screen Tiles Used For Lazy Clearing.
+  h_z_buffer.dirty_level = std::clamp(TILE_SHIFT, 1, std::max(h_z_buffer.levels - 1, 1));
+  h_z_buffer.dirty.assign(std::max(size, (size_t)1), 0);
+  h_z_buffer.policy = Setting::IMMEDIATE;
+  h_z_buffer.batch_size = 1;
+
+  Clear(h_z_buffer);
+  return h_z_buffer;
+}
+
+void HZBuffer::Clear(HZBuffer& h_z_buffer) NOEXCEPT
+{
+  if (h_z_buffer.levels == 1)
+  {
+    return;
+  }
+  std::fill_n(h_z_buffer.data, h_z_buffer.dirty.size(), h_z_buffer.z_buffer->bgz);
+  std::fill(h_z_buffer.dirty.begin(), h_z_buffer.dirty.end(), 0);
+  h_z_buffer.dirty_list.clear();
+  h_z_buffer.pending = 0;
+}
+
+void HZBuffer::Destroy(HZBuffer& h_z_buffer) NOEXCEPT
+{
+  delete[] h_z_buffer.data;
+  h_z_buffer = {};
+}
+
+void HZBuffer::Configure(HZBuffer& h_z_buffer, const Setting::UpdatePolicy policy, const int batch_size) NOEXCEPT
+{
+  if (h_z_buffer.policy != policy)
+  {
+    Flush(h_z_buffer);
+  }
+  h_z_buffer.policy = policy;
+  h_z_buffer.batch_size = std::max(batch_size, 1);
+}
+
+NODISCARD float HZBuffer::Query(HZBuffer& h_z_buffer, int xmin, int xmax, int ymin, int ymax) NOEXCEPT
+{
+  xmin = std::max(xmin, 0);
+  ymin = std::max(ymin, 0);
+  xmax = std::min(xmax, h_z_buffer.width - 1);
+  ymax = std::min(ymax, h_z_buffer.height - 1);
+
+  ++statistic.queries;
+
+  // COMMENT: A Rect Outside The Canvas Covers No Pixel, So Nothing Behind It Can Show.
+  if (xmin > xmax || ymin > ymax)
+  {
+    return -INF;
+  }
+
+  if (h_z_buffer.levels == 1)
+  {
+    return h_z_buffer.z_buffer->bgz;
+  }
+
+  // NOTE: Level 0 Is Never Read, Its Tiles May Still Hold Last Frame's Depth Until They Are Touched.
+  const int extent = std::max(xmax - xmin, ymax - ymin) + 1;
+  const int level = std::clamp((int)std::bit_width((uint32_t)extent - 1), 1, h_z_buffer.levels - 1);
+
+  const int x0 = xmin >> level, x1 = xmax >> level;
+  const int y0 = ymin >> level, y1 = ymax >> level;
+
+  if (h_z_buffer.policy == Setting::ON_DEMAND && !h_z_buffer.dirty_list.empty())
+  {
+    // COMMENT: Texels Below dirty_level Are Dirty When Their Ancestor At dirty_level Is.
+    const int check = std::max(level, h_z_buffer.dirty_level);
+    const int shift = check - level;
+    const uint8_t* flags = h_z_buffer.dirty.data() + h_z_buffer.offsets[check];
+    const int width = h_z_buffer.widths[check];
+    if (flags[(y0 >> shift) * width + (x0 >> shift)] | flags[(y0 >> shift) * width + (x1 >> shift)] | flags[(y1 >> shift) * width + (x0 >> shift)] | flags[(y1 >> shift) * width + (x1 >> shift)])
+    {
+      Flush(h_z_buffer);
+    }
+  }
+
+  const float* texels = Level(h_z_buffer, level);
+  const int width = h_z_buffer.widths[level];
+  statistic.read_texels += 4;
+
+  float zmax = std::max(texels[y0 * width + x0], texels[y0 * width + x1]);
+  zmax = std::max(zmax, texels[y1 * width + x0]);
+  zmax = std::max(zmax, texels[y1 * width + x1]);
+  return zmax;
+}
+
+void HZBuffer::Update(HZBuffer& h_z_buffer, int xmin, int xmax, int ymin, int ymax) NOEXCEPT
+{
+  xmin = std::max(xmin, 0);
+  ymin = std::max(ymin, 0);
+  xmax = std::min(xmax, h_z_buffer.width - 1);
+  ymax = std::min(ymax, h_z_buffer.height - 1);
+
+  if (xmin > xmax || ymin > ymax || h_z_buffer.levels == 1)
+  {
+    return;
+  }
+
+  if (h_z_buffer.policy == Setting::IMMEDIATE)
+  {
+    Propagate(h_z_buffer, h_z_buffer.levels - 1, xmin, xmax, ymin, ymax);
+    return;
+  }
+
+  // COMMENT: Mark The Covered Texels Of dirty_level And Their Ancestors. An Already Dirty Texel Has Dirty Ancestors, So Marking Stops There.
+  const int level = h_z_buffer.dirty_level;
+  const int width = h_z_buffer.widths[level];
+  uint8_t* flags = h_z_buffer.dirty.data() + h_z_buffer.offsets[level];
+  for (int y = ymin >> level; y <= ymax >> level; ++y)
+  {
+    for (int x = xmin >> level; x <= xmax >> level; ++x)
+    {
+      if (flags[y * width + x])
+      {
+        continue;
+      }
+      flags[y * width + x] = 1;
+      h_z_buffer.dirty_list.push_back((uint32_t)(y * width + x));
+      for (int l = level + 1, px = x >> 1, py = y >> 1; l < h_z_buffer.levels; ++l, px >>= 1, py >>= 1)
+      {
+        uint8_t& flag = h_z_buffer.dirty[h_z_buffer.offsets[l] + (size_t)py * h_z_buffer.widths[l] + px];
+        if (flag)
+        {
+          break;
+        }
+        flag = 1;
+      }
+    }
+  }
+
+  if (h_z_buffer.policy == Setting::BATCHED && ++h_z_buffer.pending >= h_z_buffer.batch_size)
+  {
+    Flush(h_z_buffer);
+  }
+}
+
+void HZBuffer::Flush(HZBuffer& h_z_buffer) NOEXCEPT
+{
+  h_z_buffer.pending = 0;
+
+  if (h_z_buffer.dirty_list.empty())
+  {
+    return;
+  }
+
+  const int level = h_z_buffer.dirty_level;
+  const int width = h_z_buffer.widths[level];
+
+  // COMMENT: Rebuild Up To dirty_level Under Each Dirty Texel.
+  for (const uint32_t texel : h_z_buffer.dirty_list)
+  {
+    const int x = (int)texel % width;
+    const int y = (int)texel / width;
+    Propagate(h_z_buffer, level, x << level, std::min(((x + 1) << level) - 1, h_z_buffer.width - 1), y << level, std::min(((y + 1) << level) - 1, h_z_buffer.height - 1));
+  }
+
+  // COMMENT: Above dirty_level, Rebuild Each Dirty Parent Once, One Level At A Time.
+  static std::vector<uint32_t> parents;
+  std::vector<uint32_t>& texels = h_z_buffer.dirty_list;
+  for (int l = level + 1; l < h_z_buffer.levels; ++l)
+  {
+    parents.clear();
+    for (const uint32_t texel : texels)
+    {
+      const int x = ((int)texel % h_z_buffer.widths[l - 1]) >> 1;
+      const int y = ((int)texel / h_z_buffer.widths[l - 1]) >> 1;
+      parents.push_back((uint32_t)(y * h_z_buffer.widths[l] + x));
+    }
+    std::sort(parents.begin(), parents.end());
+    parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+    for (const uint32_t texel : parents)
+    {
+      const int x = (int)texel % h_z_buffer.widths[l];
+      const int y = (int)texel / h_z_buffer.widths[l];
+      Reduce(h_z_buffer, l, x, x, y, y);
+    }
+    texels.swap(parents);
+  }
+
+  std::fill(h_z_buffer.dirty.begin() + (ptrdiff_t)h_z_buffer.offsets[level], h_z_buffer.dirty.end(), 0);
+  h_z_buffer.dirty_list.clear();
+}
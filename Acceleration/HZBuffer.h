@@ -16,4 +16,63 @@
 #include <Common.h>
 #include <Entity.h>
 
+// COMMENT: Z Pyramid As A Mip Chain. Level 0 Is The ZBuffer Itself, Texel (x, y) Of Level l Holds The Farthest Depth Of
+// COMMENT: Pixels [x << l, (x + 1) << l) x [y << l, (y + 1) << l). Levels Above 0 Are Stored Back To Back In One Allocation.
+struct HZBuffer
+{
+  ZBuffer* z_buffer = {};
+  int width         = {};
+  int height        = {};
+  int levels        = {};
+  float* data       = {};
+
+  std::vector<int>    widths  = {};
+  std::vector<int>    heights = {};
+  std::vector<size_t> offsets = {};
+
+  // NOTE: Depth Only Decreases Within A Frame, So A Stale Texel Is Still A Conservative Bound And Only Costs Culling Power.
+  // COMMENT: Deferred Updates Mark Texels Of dirty_level As Dirty, Together With Their Ancestors, And Flush Rebuilds Them Level By Level.
+  Setting::UpdatePolicy policy     = {};
+  int batch_size                   = {};
+  int pending                      = {};
+  int dirty_level                  = {};
+  std::vector<uint8_t>  dirty      = {};
+  std::vector<uint32_t> dirty_list = {};
+
+  // COMMENT: Counters Of The Current Frame. Texels Are Counted Above Level 0 Only, As Read By Queries And As Recomputed By Updates.
+  struct Statistic
+  {
+    uint64_t queries        = {};
+    uint64_t read_texels    = {};
+    uint64_t rebuilt_texels = {};
+  };
+
+  static Statistic statistic;
+
+  NODISCARD  static HZBuffer From(const Canvas& canvas) NOEXCEPT;
+
+   static void Clear(HZBuffer& h_z_buffer) NOEXCEPT;
+
+  // NOTE: The ZBuffer Is Not Its Own, So It Is Left Alone.
+   static void Destroy(HZBuffer& h_z_buffer) NOEXCEPT;
+
+   static void Configure(HZBuffer& h_z_buffer, Setting::UpdatePolicy policy, int batch_size) NOEXCEPT;
+
+  NODISCARD FORCE_INLINE static float* Level(const HZBuffer& h_z_buffer, const int level) NOEXCEPT
+  {
+    ASSERT(0 < level && level < h_z_buffer.levels);
+    return h_z_buffer.data + h_z_buffer.offsets[level];
+  }
+
+  // COMMENT: Farthest Depth Over A Canvas Rect. The Rect Is Read At The Level Whose Texels Are At Least As Large, So At Most 2x2 Texels.
+  // NOTE: With ON_DEMAND, Reading A Dirty Texel Flushes First.
+  NODISCARD  static float Query(HZBuffer& h_z_buffer, int xmin, int xmax, int ymin, int ymax) NOEXCEPT;
+
+  // COMMENT: Report A Rect Of The ZBuffer That Was Written. Its Texels Are Rebuilt Now Or Later, Depending On The Policy.
+   static void Update(HZBuffer& h_z_buffer, int xmin, int xmax, int ymin, int ymax) NOEXCEPT;
+
+  // COMMENT: Rebuild Every Dirty Texel. Called At Scheduled Points, Such As After Each Model.
+   static void Flush(HZBuffer& h_z_buffer) NOEXCEPT;
+};
+
 #endif //HZBUFFER_H
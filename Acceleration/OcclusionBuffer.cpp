@@ -0,0 +1,235 @@
+/**
+  ******************************************************************************
+  * @file           : OcclusionBuffer.cpp
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#include <Acceleration/OcclusionBuffer.h>
+
+#if defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
+// COMMENT: Polygons Smaller Than This Many Buffer Pixels Cannot Cover One Once Shrunk, So They Are Skipped Before Setup.
+CONSTEXPR float MIN_AREA = 4.0f;
+
+// COMMENT: Mask Of Bits [lo, hi] Of A Tile Row.
+NODISCARD static uint32_t RowMask(const int lo, const int hi) NOEXCEPT
+{
+  if (lo > hi)
+  {
+    return 0u;
+  }
+  const int n = hi - lo + 1;
+  return (n == 32 ? ~0u : ((1u << n) - 1u)) << lo;
+}
+
+void OcclusionBuffer::Clear(OcclusionBuffer& occlusion_buffer, const Canvas& canvas) NOEXCEPT
+{
+  occlusion_buffer.sx = (float)OCCLUSION_WIDTH / (float)canvas.width;
+  occlusion_buffer.sy = (float)OCCLUSION_HEIGHT / (float)canvas.height;
+  occlusion_buffer.tiles.assign((size_t)OCCLUSION_TILE_COLS * (OCCLUSION_HEIGHT / OCCLUSION_TILE_ROWS), Tile{ .mask = {}, .z0 = INF, .z1 = -INF });
+}
+
+NODISCARD bool OcclusionBuffer::Render(OcclusionBuffer& occlusion_buffer, const Vertex* points, const int count) NOEXCEPT
+{
+  const float sx = occlusion_buffer.sx;
+  const float sy = occlusion_buffer.sy;
+
+  if (count < 3 || count > OCCLUSION_MAX_SIDES)
+  {
+    return false;
+  }
+
+  float area = 0.0f;
+  glm::vec2 vmin(INF), vmax(-INF);
+  for (int i = 0; i < count; ++i)
+  {
+    const Vertex& p = points[i];
+    const Vertex& q = points[(i + 1) % count];
+    area += p.x * q.y - q.x * p.y;
+    vmin = glm::min(vmin, glm::vec2(p));
+    vmax = glm::max(vmax, glm::vec2(p));
+  }
+  if (std::abs(area) * 0.5f * sx * sy < MIN_AREA)
+  {
+    return false;
+  }
+
+  // COMMENT: Depth Plane Through The First Three Vertices, As The Rasterizers Use.
+  const Normal n = glm::normalize(glm::cross(points[0] - points[1], points[1] - points[2]));
+  if (n.z == 0.0f)
+  {
+    return false;
+  }
+  const float A = -n.x / n.z;
+  const float B = -n.y / n.z;
+  const float C = glm::dot(n, points[0]) / n.z;
+
+  // COMMENT: Edge i Is a * x + b * y + c >= 0 Inside, Whatever The Winding.
+  const float s = area > 0.0f ? 1.0f : -1.0f;
+  float a[OCCLUSION_MAX_SIDES], b[OCCLUSION_MAX_SIDES], c[OCCLUSION_MAX_SIDES];
+  for (int i = 0; i < count; ++i)
+  {
+    const Vertex& p = points[i];
+    const Vertex& q = points[(i + 1) % count];
+    a[i] = -(q.y - p.y) * s;
+    b[i] = (q.x - p.x) * s;
+    c[i] = ((q.y - p.y) * p.x - (q.x - p.x) * p.y) * s;
+  }
+
+  const int Y0 = std::max((int)std::floor(vmin.y * sy), 0);
+  const int Y1 = std::min((int)std::floor(vmax.y * sy), OCCLUSION_HEIGHT - 1);
+
+  for (int ty = Y0 / OCCLUSION_TILE_ROWS; ty <= Y1 / OCCLUSION_TILE_ROWS; ++ty)
+  {
+    // COMMENT: Buffer Row Y Spans Canvas Rows [Y / sy, (Y + 1) / sy], Grown By A Canvas Pixel. Each Edge Bounds The Buffer Pixels Of The Row That Lie Wholly Inside It.
+    // COMMENT: Pixel X Spans [X / sx - 1, (X + 1) / sx + 1], So It Is Covered For X In [sx * (L + 1), sx * (R - 1) - 1].
+    float L[OCCLUSION_TILE_ROWS], R[OCCLUSION_TILE_ROWS];
+    const float y = (float)(ty * OCCLUSION_TILE_ROWS);
+#if defined(__SSE2__)
+    {
+      const __m128 row = _mm_add_ps(_mm_set1_ps(y), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+      const __m128 ylo = _mm_sub_ps(_mm_div_ps(row, _mm_set1_ps(sy)), _mm_set1_ps(1.0f));
+      const __m128 yhi = _mm_add_ps(_mm_div_ps(_mm_add_ps(row, _mm_set1_ps(1.0f)), _mm_set1_ps(sy)), _mm_set1_ps(1.0f));
+      __m128 lv = _mm_set1_ps(-INF);
+      __m128 rv = _mm_set1_ps(INF);
+      for (int i = 0; i < count; ++i)
+      {
+        const __m128 bv = _mm_set1_ps(b[i]);
+        const __m128 k = _mm_add_ps(_mm_set1_ps(c[i]), _mm_min_ps(_mm_mul_ps(bv, ylo), _mm_mul_ps(bv, yhi)));
+        if (a[i] > 0.0f)
+        {
+          lv = _mm_max_ps(lv, _mm_div_ps(k, _mm_set1_ps(-a[i])));
+        }
+        else if (a[i] < 0.0f)
+        {
+          rv = _mm_min_ps(rv, _mm_div_ps(k, _mm_set1_ps(-a[i])));
+        }
+        else
+        {
+          // NOTE: A Horizontal Edge Either Keeps A Whole Row Or None Of It.
+          const __m128 empty = _mm_cmplt_ps(k, _mm_setzero_ps());
+          lv = _mm_or_ps(_mm_and_ps(empty, _mm_set1_ps(INF)), _mm_andnot_ps(empty, lv));
+        }
+      }
+      _mm_storeu_ps(L, lv);
+      _mm_storeu_ps(R, rv);
+    }
+#else
+    for (int r = 0; r < OCCLUSION_TILE_ROWS; ++r)
+    {
+      const float ylo = (y + (float)r) / sy - 1.0f;
+      const float yhi = (y + (float)r + 1.0f) / sy + 1.0f;
+      L[r] = -INF, R[r] = INF;
+      for (int i = 0; i < count; ++i)
+      {
+        const float k = c[i] + std::min(b[i] * ylo, b[i] * yhi);
+        if (a[i] > 0.0f)      { L[r] = std::max(L[r], k / -a[i]); }
+        else if (a[i] < 0.0f) { R[r] = std::min(R[r], k / -a[i]); }
+        else if (k < 0.0f)    { L[r] = INF; }
+      }
+    }
+#endif
+
+    int X0[OCCLUSION_TILE_ROWS], X1[OCCLUSION_TILE_ROWS];
+    int xmin = OCCLUSION_WIDTH, xmax = -1;
+    for (int r = 0; r < OCCLUSION_TILE_ROWS; ++r)
+    {
+      const int Y = ty * OCCLUSION_TILE_ROWS + r;
+      X0[r] = (int)std::ceil(std::clamp(sx * (L[r] + 1.0f), -1.0f, (float)OCCLUSION_WIDTH));
+      X1[r] = (int)std::floor(std::clamp(sx * (R[r] - 1.0f) - 1.0f, -1.0f, (float)OCCLUSION_WIDTH));
+      X0[r] = std::max(X0[r], 0);
+      X1[r] = std::min(X1[r], OCCLUSION_WIDTH - 1);
+      if (Y < Y0 || Y > Y1 || X0[r] > X1[r])
+      {
+        X0[r] = OCCLUSION_WIDTH, X1[r] = -1;
+        continue;
+      }
+      xmin = std::min(xmin, X0[r]);
+      xmax = std::max(xmax, X1[r]);
+    }
+
+    for (int tx = std::max(xmin, 0) >> OCCLUSION_TILE_SHIFT; tx <= xmax >> OCCLUSION_TILE_SHIFT; ++tx)
+    {
+      const int base = tx << OCCLUSION_TILE_SHIFT;
+      uint32_t mask[OCCLUSION_TILE_ROWS];
+      uint32_t any = 0u;
+      for (int r = 0; r < OCCLUSION_TILE_ROWS; ++r)
+      {
+        mask[r] = RowMask(std::max(X0[r], base) - base, std::min(X1[r], base + 31) - base);
+        any |= mask[r];
+      }
+      if (any == 0u)
+      {
+        continue;
+      }
+
+      // COMMENT: Farthest Plane Depth Over The Tile And The Polygon's Bounds, Both Grown By A Canvas Pixel. The Plane Is Linear, So A Corner Holds It.
+      const float x0 = std::max((float)base / sx, vmin.x) - 1.0f;
+      const float x1 = std::min((float)(base + 32) / sx, vmax.x) + 1.0f;
+      const float y0 = std::max(y / sy, vmin.y) - 1.0f;
+      const float y1 = std::min((y + (float)OCCLUSION_TILE_ROWS) / sy, vmax.y) + 1.0f;
+      const float z = C + std::max(A * x0, A * x1) + std::max(B * y0, B * y1);
+
+      Tile& tile = occlusion_buffer.tiles[ty * OCCLUSION_TILE_COLS + tx];
+      if (z >= tile.z0)
+      {
+        continue;
+      }
+      // COMMENT: Merge Into The Working Layer. When Pushing It Back Would Cost More Than It Can Gain Over z0, The Layer Starts Over From This Polygon.
+      if (z - tile.z1 > tile.z0 - z)
+      {
+        std::fill_n(tile.mask, OCCLUSION_TILE_ROWS, 0u);
+        tile.z1 = -INF;
+      }
+      uint32_t full = ~0u;
+      for (int r = 0; r < OCCLUSION_TILE_ROWS; ++r)
+      {
+        tile.mask[r] |= mask[r];
+        full &= tile.mask[r];
+      }
+      tile.z1 = std::max(tile.z1, z);
+      if (full == ~0u)
+      {
+        tile.z0 = tile.z1;
+        std::fill_n(tile.mask, OCCLUSION_TILE_ROWS, 0u);
+        tile.z1 = -INF;
+      }
+    }
+  }
+  return true;
+}
+
+NODISCARD bool OcclusionBuffer::Query(const OcclusionBuffer& occlusion_buffer, const glm::ivec4& rect, const float znear) NOEXCEPT
+{
+  // NOTE: Canvas Pixel i Spans [i - 0.5, i + 0.5].
+  const int X0 = std::max((int)std::floor(((float)rect.x - 0.5f) * occlusion_buffer.sx), 0);
+  const int X1 = std::min((int)std::floor(((float)rect.y + 0.5f) * occlusion_buffer.sx), OCCLUSION_WIDTH - 1);
+  const int Y0 = std::max((int)std::floor(((float)rect.z - 0.5f) * occlusion_buffer.sy), 0);
+  const int Y1 = std::min((int)std::floor(((float)rect.w + 0.5f) * occlusion_buffer.sy), OCCLUSION_HEIGHT - 1);
+
+  for (int Y = Y0; Y <= Y1; ++Y)
+  {
+    const int ty = Y / OCCLUSION_TILE_ROWS;
+    const int r = Y % OCCLUSION_TILE_ROWS;
+    for (int tx = X0 >> OCCLUSION_TILE_SHIFT; tx <= X1 >> OCCLUSION_TILE_SHIFT; ++tx)
+    {
+      const int base = tx << OCCLUSION_TILE_SHIFT;
+      const Tile& tile = occlusion_buffer.tiles[ty * OCCLUSION_TILE_COLS + tx];
+      const uint32_t mask = RowMask(std::max(X0, base) - base, std::min(X1, base + 31) - base);
+      const float z = (tile.mask[r] & mask) == mask ? std::min(tile.z0, tile.z1) : tile.z0;
+      if (z >= znear)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file           : OcclusionBuffer.h
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#ifndef OCCLUSIONBUFFER_H
+#define OCCLUSIONBUFFER_H
+
+#include <Common.h>
+#include <Entity.h>
+
+// COMMENT: Resolution Of The Occlusion Buffer, Whatever The Canvas Size. Tiles Are 32 x 4 Pixels, One Mask Bit Per Pixel.
+CONSTEXPR int OCCLUSION_WIDTH      = 256;
+CONSTEXPR int OCCLUSION_HEIGHT     = 128;
+CONSTEXPR int OCCLUSION_TILE_SHIFT = 5;
+CONSTEXPR int OCCLUSION_TILE_ROWS  = 4;
+CONSTEXPR int OCCLUSION_TILE_COLS  = OCCLUSION_WIDTH >> OCCLUSION_TILE_SHIFT;
+
+// COMMENT: Polygons With More Sides Are Not Used As Occluders.
+CONSTEXPR int OCCLUSION_MAX_SIDES  = 8;
+
+// COMMENT: Masked Occlusion Buffer After Hasselgren Et Al., "Masked Software Occlusion Culling". Each Tile Keeps Two Depth Layers Instead Of Per Pixel Depths.
+// COMMENT: z0 Bounds Every Pixel Of The Tile. z1 Bounds The Pixels Set In mask, Which Are Being Gathered Until They Cover The Tile And Replace z0.
+// NOTE: Occluders Only Mark Pixels They Cover Entirely, With A Canvas Pixel To Spare, So Every Bound Holds For The Full Resolution ZBuffer Too.
+struct OcclusionBuffer
+{
+  struct Tile
+  {
+    uint32_t mask[OCCLUSION_TILE_ROWS] = {};
+    float z0                           = {};
+    float z1                           = {};
+  };
+
+  // NOTE: Buffer Pixels Per Canvas Pixel.
+  float sx                = {};
+  float sy                = {};
+  std::vector<Tile> tiles = {};
+
+  static void Clear(OcclusionBuffer& occlusion_buffer, const Canvas& canvas) NOEXCEPT;
+
+  // COMMENT: Rasterize A Polygon Given By Its Canvas Space Vertices As An Occluder. Returns false When It Is Too Small To Cover A Buffer Pixel.
+  // NOTE: Only The Pixels Inside Every Edge Are Covered, Which Stays Inside The Polygon Even When It Is Not Convex.
+  NODISCARD static bool Render(OcclusionBuffer& occlusion_buffer, const Vertex* points, int count) NOEXCEPT;
+
+  // COMMENT: true When A Canvas Rect Whose Nearest Depth Is znear Is Hidden Behind The Occluders.
+  NODISCARD static bool Query(const OcclusionBuffer& occlusion_buffer, const glm::ivec4& rect, float znear) NOEXCEPT;
+};
+
+#endif //OCCLUSIONBUFFER_H
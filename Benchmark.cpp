@@ -0,0 +1,586 @@
+/**
+  ******************************************************************************
+  * @file           : Benchmark.cpp
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#include <Common.h>
+#include <Entity.h>
+#include <Pipeline.h>
+#include <Rasterizer.h>
+#include <Actor.h>
+#include <Loader.h>
+#include <Parallel.h>
+#include <Acceleration/HZBuffer.h>
+#include <Profiler.h>
+
+#if defined(_WIN32)
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+#endif
+
+CONSTEXPR int BENCH_WIDTH  = 1024;
+CONSTEXPR int BENCH_HEIGHT = 1024;
+
+// COMMENT: Degrees The Camera Orbits Around The Scene Per Frame, Warm Up Included.
+CONSTEXPR float ORBIT_STEP = 3.0f;
+
+// COMMENT: Work Counters Reported Per Case, Named By WORK_NAMES.
+CONSTEXPR int WORK_COUNT = 12;
+
+// COMMENT: Name Of Each Setting::Algorithm, In Enum Order.
+static const char* ALGORITHM_NAMES[] = {
+  "ScanConvertZBuffer",
+  "ScanConvertHZBuffer",
+  "ScanConvertHAABBHZBuffer",
+  "IntervalScanLine",
+  "ScanConvertBVHHZBuffer",
+};
+
+struct Options
+{
+  int frames = 120;
+  int warmup = 10;
+  std::string models = (std::filesystem::path(STR(PROJECT_DIR)) / "Model").string();
+  std::string filter = {};
+  const char* csv = nullptr;
+  const char* json = nullptr;
+  bool counters = false;
+  int threads = 0;
+};
+
+// COMMENT: A Scene To Measure And The Distance The Camera Orbits It At.
+struct Case
+{
+  std::string name = {};
+  Scene scene = {};
+  float radius = {};
+};
+
+// NOTE: Frame Times Are In Microseconds. Peak RSS Is The Process Peak So Far, In KiB, So It Only Grows Over The Run.
+struct Result
+{
+  std::string scene = {};
+  Setting::Algorithm algorithm = {};
+  bool cull = {};
+  bool clip = {};
+  int threads = {};
+  int frames = {};
+  double mean = {};
+  double p50 = {};
+  double p95 = {};
+  double p99 = {};
+  uint64_t peak_rss = {};
+  // COMMENT: Work Counters Per Measured Frame, In WORK_NAMES Order.
+  double work[WORK_COUNT] = {};
+#ifdef ENABLE_PROFILER
+  // COMMENT: Mean Hardware Counts Per Measured Frame And Stage, Set With --counters. available Is Profiler::CountersAvailable.
+  bool counted = {};
+  uint32_t available = {};
+  double counts[Profiler::STAGE_COUNT][Profiler::COUNTER_COUNT] = {};
+#endif
+};
+
+// COMMENT: Output Name Of Each Work Counter, As Filled By Work.
+static const char* WORK_NAMES[WORK_COUNT] = {
+  "polygons",
+  "backface_culled",
+  "clipped",
+  "occluded",
+  "rasterized",
+  "zbh_queries",
+  "zbh_texels_rebuilt",
+  "haabb_nodes",
+  "haabb_culled",
+  "spans",
+  "tested_pixels",
+  "written_pixels",
+};
+
+static void Usage() NOEXCEPT
+{
+  fmt::printf(
+    "Usage: SoftwareRendererBench [--frames N] [--warmup N] [--models DIR] [--filter TEXT] [--csv FILE] [--json FILE] [--counters] [--threads N]\n"
+    "  --frames  Measured Frames Per Run. Default 120.\n"
+    "  --warmup  Frames Rendered Before Measuring. Default 10.\n"
+    "  --models  Directory Of .obj Models, One Case Each. Default Model.\n"
+    "  --filter  Only Run Cases Whose Name Contains TEXT.\n"
+    "  --csv     Write Results As CSV. Without --csv Or --json, CSV Goes To stdout.\n"
+    "  --json    Write Results As JSON.\n"
+    "  --counters  Add Hardware Counters Per Frame, And Per Stage In JSON. Needs Linux And The Profiler Build. Reading Them Slows Frames.\n"
+    "  --threads   Render With Enable Parallel On N Threads, The Caller Included. Default 0, Serial.\n"
+  );
+}
+
+NODISCARD static Options Parse(const int argc, char** argv) NOEXCEPT
+{
+  Options options;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--frames" && has_value)
+    {
+      options.frames = std::max(atoi(argv[++i]), 1);
+    }
+    else if (arg == "--warmup" && has_value)
+    {
+      options.warmup = std::max(atoi(argv[++i]), 0);
+    }
+    else if (arg == "--models" && has_value)
+    {
+      options.models = argv[++i];
+    }
+    else if (arg == "--filter" && has_value)
+    {
+      options.filter = argv[++i];
+    }
+    else if (arg == "--csv" && has_value)
+    {
+      options.csv = argv[++i];
+    }
+    else if (arg == "--json" && has_value)
+    {
+      options.json = argv[++i];
+    }
+    else if (arg == "--counters")
+    {
+      options.counters = true;
+    }
+    else if (arg == "--threads" && has_value)
+    {
+      options.threads = std::max(atoi(argv[++i]), 0);
+    }
+    else
+    {
+      Usage();
+      exit(arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  }
+  return options;
+}
+
+NODISCARD static uint64_t PeakRSS() NOEXCEPT
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return (uint64_t)counters.PeakWorkingSetSize / 1024;
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+  #if defined(__APPLE__)
+    return (uint64_t)usage.ru_maxrss / 1024;
+  #else
+    return (uint64_t)usage.ru_maxrss;
+  #endif
+#endif
+}
+
+// COMMENT: Work Counters Of The Last Rendered Frame, In WORK_NAMES Order.
+static void Work(double work[WORK_COUNT]) NOEXCEPT
+{
+  work[0]  = (double)Pipeline::statistic.input_polygons;
+  work[1]  = (double)Pipeline::statistic.backface_culled;
+  work[2]  = (double)Pipeline::statistic.clipped_polygons;
+  work[3]  = (double)Rasterizer::statistic.occluded_polygons;
+  work[4]  = (double)Rasterizer::statistic.rasterized_polygons;
+  work[5]  = (double)HZBuffer::statistic.queries;
+  work[6]  = (double)HZBuffer::statistic.rebuilt_texels;
+  work[7]  = (double)Rasterizer::statistic.haabb_nodes;
+  work[8]  = (double)Rasterizer::statistic.haabb_culled;
+  work[9]  = (double)Rasterizer::statistic.spans;
+  work[10] = (double)Rasterizer::statistic.tested_pixels;
+  work[11] = (double)Rasterizer::statistic.written_pixels;
+}
+
+// COMMENT: Nearest Rank Percentile Of Sorted Samples.
+NODISCARD static double Percentile(const std::vector<double>& sorted, const double p) NOEXCEPT
+{
+  const size_t rank = (size_t)std::ceil(p / 100.0 * (double)sorted.size());
+  return sorted[std::clamp(rank, (size_t)1, sorted.size()) - 1];
+}
+
+// COMMENT: The Lights Of The Interactive Scene.
+static void AddLights(Scene& scene) NOEXCEPT
+{
+  scene.parallel_lights.emplace_back(ParallelLight{ .direction = Vector(1.0f, -1.0f, 0.0f), .color = Color(1.0f, 0.5f, 0.5f) });
+  scene.parallel_lights.emplace_back(ParallelLight{ .direction = Vector(1.0f, 1.0f, 0.0f), .color = Color(0.5f, 0.5f, 1.0f) });
+  scene.point_lights.emplace_back(PointLight{ .position = Vertex(2.0f, 2.0f, 0.0f), .color = Color(0.5f, 1.0f, 0.5f) });
+  scene.point_lights.emplace_back(PointLight{ .position = Vertex(2.0f, -2.0f, 0.0f), .color = Color(1.0f, 1.0f, 1.0f) });
+}
+
+// COMMENT: One Case Per Model In The Directory, In Name Order. Models That Fail To Load, Such As Unfetched LFS Pointers, Are Skipped.
+static void AddModelCases(const Options& options, std::vector<Case>& cases) NOEXCEPT
+{
+  std::vector<std::string> filenames;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(options.models, error))
+  {
+    if (entry.path().extension() == ".obj")
+    {
+      filenames.emplace_back(entry.path().string());
+    }
+  }
+  std::sort(filenames.begin(), filenames.end());
+
+  for (const auto& filename : filenames)
+  {
+    const std::string name = std::filesystem::path(filename).filename().string();
+    if (name.find(options.filter) == std::string::npos)
+    {
+      continue;
+    }
+    Model model;
+    if (Loader::LoadObj(filename.c_str(), model) != Loader::SUCCESS || model.polygon_sides.empty())
+    {
+      fmt::fprintf(stderr, "Skip %s, Can Not Load It\n", filename);
+      continue;
+    }
+    Case& bench_case = cases.emplace_back();
+    bench_case.name = name;
+    bench_case.radius = 2.0f;
+    bench_case.scene.models.emplace_back(std::move(model));
+    AddLights(bench_case.scene);
+  }
+}
+
+// COMMENT: Occlusion Heavy Built In Case. Ten Dragons Sit Inside A Cube, So From Any Point Of The Orbit The Cube Hides Them All.
+static void AddDragonsCase(const Options& options, std::vector<Case>& cases) NOEXCEPT
+{
+  const std::string name = "dragons_in_cube";
+  if (name.find(options.filter) == std::string::npos)
+  {
+    return;
+  }
+  Model cube, dragon;
+  if (Loader::LoadObj((std::filesystem::path(options.models) / "cube.obj").string().c_str(), cube) != Loader::SUCCESS || cube.polygon_sides.empty() ||
+      Loader::LoadObj((std::filesystem::path(options.models) / "dragon_vrip.obj").string().c_str(), dragon) != Loader::SUCCESS || dragon.polygon_sides.empty())
+  {
+    fmt::fprintf(stderr, "Skip %s, Can Not Load cube.obj Or dragon_vrip.obj\n", name);
+    return;
+  }
+
+  Case& bench_case = cases.emplace_back();
+  bench_case.name = name;
+  bench_case.radius = 3.5f;
+  // NOTE: The Loader Scales Every Model To Extents Summing To 6, So The Cube Spans [-1, 1] And A Dragon Scaled By 0.15 Fits Well Inside.
+  // NOTE: The Cube Comes First, So Algorithms Drawing In Scene Order Also Have It In The Z Pyramid Before Any Dragon.
+  bench_case.scene.models.emplace_back(std::move(cube));
+  for (int k = 0; k < 10; ++k)
+  {
+    Model& copy = bench_case.scene.models.emplace_back(dragon);
+    copy.scale = glm::vec3(0.15f);
+    copy.translate = glm::vec3(0.3f * (float)(k % 5) - 0.6f, 0.5f * (float)(k / 5) - 0.25f, 0.0f);
+  }
+  AddLights(bench_case.scene);
+}
+
+// COMMENT: Render warmup + frames Frames Along The Orbit And Time Each Measured One, Buffer Clears Included As In The Interactive Loop.
+NODISCARD static Result Run(const Options& options, const Case& bench_case, const Setting& setting, Canvas& canvas) NOEXCEPT
+{
+  Shader::Config config;
+  config.ka = 0.1f;
+  config.kd = 0.5f;
+  config.ks = 0.4f;
+  config.ps = 2.5f;
+
+  Camera camera;
+  camera.up     = Vector(0.0f, 1.0f, 0.0f);
+  camera.pitch  = 0.0f;
+  camera.fov    = glm::radians(75.0f);
+  camera.aspect = (float)BENCH_WIDTH / (float)BENCH_HEIGHT;
+  camera.near   = 0.1f;
+  camera.far    = 100.0f;
+
+  Result result;
+  std::vector<double> samples;
+  samples.reserve(options.frames);
+  for (int frame = 0; frame < options.warmup + options.frames; ++frame)
+  {
+    // COMMENT: Orbit The Origin, Always Looking At It.
+    camera.yaw = glm::radians(180.0f + ORBIT_STEP * (float)frame);
+    Actor::OnUpdate(camera);
+    camera.position = -bench_case.radius * camera.direction;
+
+    FrameBuffer::Clear(*canvas.frame_buffer);
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    if (setting.algorithm != Setting::IntervalScanLine)
+    {
+      ZBuffer::Clear(*canvas.z_buffer);
+      HZBuffer::Clear(*canvas.h_z_buffer);
+    }
+    Pipeline::Render(setting, config, canvas, camera, bench_case.scene);
+
+    const auto end_time = std::chrono::steady_clock::now();
+
+    FrameBuffer::Display(*canvas.frame_buffer);
+
+    PROFILE_END_FRAME();
+
+    if (frame >= options.warmup)
+    {
+      samples.emplace_back(std::chrono::duration<double, std::micro>(end_time - start_time).count());
+      double work[WORK_COUNT];
+      Work(work);
+      for (int k = 0; k < WORK_COUNT; ++k)
+      {
+        result.work[k] += work[k] / (double)options.frames;
+      }
+#ifdef ENABLE_PROFILER
+      for (int stage = 0; stage < Profiler::STAGE_COUNT; ++stage)
+      {
+        for (int counter = 0; counter < Profiler::COUNTER_COUNT; ++counter)
+        {
+          result.counts[stage][counter] += (double)Profiler::frame_counts[stage][counter] / (double)options.frames;
+        }
+      }
+#endif
+    }
+  }
+
+  result.scene = bench_case.name;
+  result.algorithm = setting.algorithm;
+  result.cull = setting.enable_cull;
+  result.clip = setting.enable_clip;
+  result.threads = setting.enable_parallel ? ThreadPool::Concurrency() : 1;
+  result.frames = options.frames;
+  result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / (double)samples.size();
+  std::sort(samples.begin(), samples.end());
+  result.p50 = Percentile(samples, 50.0);
+  result.p95 = Percentile(samples, 95.0);
+  result.p99 = Percentile(samples, 99.0);
+  result.peak_rss = PeakRSS();
+#ifdef ENABLE_PROFILER
+  result.counted = options.counters;
+  result.available = Profiler::CountersAvailable();
+#endif
+  return result;
+}
+
+#ifdef ENABLE_PROFILER
+// COMMENT: Output Name Of Each Profiler::Counter, In Enum Order.
+static const char* COUNTER_NAMES[] = {
+  "cycles",
+  "instructions",
+  "l1d_misses",
+  "llc_misses",
+  "branch_misses",
+};
+
+// COMMENT: Counts Of stage, Or Of The Whole Frame When stage Is STAGE_COUNT, As CSV Fields Or JSON Members. Counters Not Available Are Empty Or null.
+NODISCARD static std::string Counters(const Result& result, const int stage, const bool json) NOEXCEPT
+{
+  double counts[Profiler::COUNTER_COUNT] = {};
+  for (int s = 0; s < Profiler::STAGE_COUNT; ++s)
+  {
+    for (int counter = 0; counter < Profiler::COUNTER_COUNT && (s == stage || stage == Profiler::STAGE_COUNT); ++counter)
+    {
+      counts[counter] += result.counts[s][counter];
+    }
+  }
+  std::string text;
+  for (int counter = 0; counter < Profiler::COUNTER_COUNT; ++counter)
+  {
+    const std::string value = (result.available & (1u << counter)) ? fmt::sprintf("%.0f", counts[counter]) : (json ? "null" : "");
+    text += json ? fmt::sprintf("\"%s\": %s, ", COUNTER_NAMES[counter], value) : "," + value;
+  }
+  const bool ipc = (result.available & (1u << Profiler::CYCLES)) && (result.available & (1u << Profiler::INSTRUCTIONS)) && counts[Profiler::CYCLES] > 0.0;
+  const std::string value = ipc ? fmt::sprintf("%.3f", counts[Profiler::INSTRUCTIONS] / counts[Profiler::CYCLES]) : (json ? "null" : "");
+  return json ? "{" + text + "\"ipc\": " + value + "}" : text + "," + value;
+}
+
+// COMMENT: JSON Key Of A Stage, Such As haabb_build.
+NODISCARD static std::string Key(const Profiler::Stage stage) NOEXCEPT
+{
+  std::string key = Profiler::Name(stage);
+  for (auto& c : key)
+  {
+    c = c == ' ' ? '_' : (char)tolower(c);
+  }
+  return key;
+}
+#endif
+
+static void WriteCSV(FILE* fp, const std::vector<Result>& results) NOEXCEPT
+{
+  fmt::fprintf(fp, "scene,algorithm,cull,clip,threads,frames,mean_us,p50_us,p95_us,p99_us,peak_rss_kib");
+  for (const auto& name : WORK_NAMES)
+  {
+    fmt::fprintf(fp, ",%s", name);
+  }
+#ifdef ENABLE_PROFILER
+  // NOTE: Counts Are Per Frame, Summed Over The Stages.
+  if (!results.empty() && results.front().counted)
+  {
+    for (const auto& name : COUNTER_NAMES)
+    {
+      fmt::fprintf(fp, ",%s", name);
+    }
+    fmt::fprintf(fp, ",ipc");
+  }
+#endif
+  fmt::fprintf(fp, "\n");
+  for (const auto& result : results)
+  {
+    fmt::fprintf(fp, "%s,%s,%d,%d,%d,%d,%.1f,%.1f,%.1f,%.1f,%llu",
+      result.scene, ALGORITHM_NAMES[result.algorithm], (int)result.cull, (int)result.clip, result.threads, result.frames,
+      result.mean, result.p50, result.p95, result.p99, (unsigned long long)result.peak_rss);
+    for (const double work : result.work)
+    {
+      fmt::fprintf(fp, ",%.1f", work);
+    }
+#ifdef ENABLE_PROFILER
+    if (result.counted)
+    {
+      fmt::fprintf(fp, "%s", Counters(result, Profiler::STAGE_COUNT, false));
+    }
+#endif
+    fmt::fprintf(fp, "\n");
+  }
+}
+
+static void WriteJSON(FILE* fp, const std::vector<Result>& results) NOEXCEPT
+{
+  fmt::fprintf(fp, "[\n");
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& result = results[i];
+    fmt::fprintf(fp,
+      "  {\"scene\": \"%s\", \"algorithm\": \"%s\", \"cull\": %s, \"clip\": %s, \"threads\": %d, \"frames\": %d, "
+      "\"mean_us\": %.1f, \"p50_us\": %.1f, \"p95_us\": %.1f, \"p99_us\": %.1f, \"peak_rss_kib\": %llu",
+      result.scene, ALGORITHM_NAMES[result.algorithm], result.cull ? "true" : "false", result.clip ? "true" : "false", result.threads, result.frames,
+      result.mean, result.p50, result.p95, result.p99, (unsigned long long)result.peak_rss);
+    fmt::fprintf(fp, ", \"work\": {");
+    for (int k = 0; k < WORK_COUNT; ++k)
+    {
+      fmt::fprintf(fp, "%s\"%s\": %.1f", k == 0 ? "" : ", ", WORK_NAMES[k], result.work[k]);
+    }
+    fmt::fprintf(fp, "}");
+#ifdef ENABLE_PROFILER
+    // NOTE: Counts Are Per Frame, For The Whole Frame And For Each Stage.
+    if (result.counted)
+    {
+      fmt::fprintf(fp, ", \"counters\": {\"total\": %s", Counters(result, Profiler::STAGE_COUNT, true));
+      for (int stage = 0; stage < Profiler::STAGE_COUNT; ++stage)
+      {
+        fmt::fprintf(fp, ", \"%s\": %s", Key((Profiler::Stage)stage), Counters(result, stage, true));
+      }
+      fmt::fprintf(fp, "}");
+    }
+#endif
+    fmt::fprintf(fp, "}%s\n", i + 1 == results.size() ? "" : ",");
+  }
+  fmt::fprintf(fp, "]\n");
+}
+
+static void Write(const char* filename, const std::vector<Result>& results, void (*write)(FILE*, const std::vector<Result>&)) NOEXCEPT
+{
+  FILE* fp = fopen(filename, "wb");
+  if (fp == nullptr)
+  {
+    Fatal("Can Not Open %s", filename);
+  }
+  write(fp, results);
+  if (fclose(fp) != 0)
+  {
+    Fatal("Can Not Close %s", filename);
+  }
+}
+
+int main(const int argc, char** argv)
+{
+  const Options options = Parse(argc, argv);
+
+  if (options.counters)
+  {
+#ifdef ENABLE_PROFILER
+    Profiler::EnableCounters(true);
+#else
+    fmt::fprintf(stderr, "Built Without The Profiler, --counters Is Ignored\n");
+#endif
+  }
+
+  std::vector<Case> cases;
+  AddModelCases(options, cases);
+  AddDragonsCase(options, cases);
+  if (cases.empty())
+  {
+    Fatal("No Case To Run");
+  }
+
+  FrameBuffer frame_buffer = FrameBuffer::From(BENCH_WIDTH, BENCH_HEIGHT, SDL_PIXELFORMAT_XRGB8888, Color(0.70f, 0.60f, 0.80f));
+  ZBuffer z_buffer = ZBuffer::From(frame_buffer, INF);
+  Canvas canvas;
+  canvas.offsetx      = 0;
+  canvas.offsety      = 0;
+  canvas.width        = BENCH_WIDTH;
+  canvas.height       = BENCH_HEIGHT;
+  canvas.frame_buffer = &frame_buffer;
+  canvas.z_buffer     = &z_buffer;
+  HZBuffer h_z_buffer = HZBuffer::From(canvas);
+  canvas.h_z_buffer   = &h_z_buffer;
+
+  // NOTE: Everything Else Stays As The Interactive Renderer Starts.
+  Setting setting;
+  setting.display_mode  = Setting::NORMAL;
+  setting.update_policy = Setting::IMMEDIATE;
+  setting.batch_size    = 64;
+
+  // NOTE: The Pool Is Sized Before The First Frame, So Its Threads Start Outside Any Measured One.
+  if (options.threads > 0)
+  {
+    ThreadPool::Resize(options.threads);
+    setting.enable_parallel = true;
+  }
+
+  std::vector<Result> results;
+  for (const auto& bench_case : cases)
+  {
+    for (int algorithm = Setting::ScanConvertZBuffer; algorithm <= Setting::ScanConvertBVHHZBuffer; ++algorithm)
+    {
+      for (int flags = 0; flags < 4; ++flags)
+      {
+        setting.algorithm = (Setting::Algorithm)algorithm;
+        setting.enable_cull = (flags & 1) == 0;
+        setting.enable_clip = (flags & 2) == 0;
+        const Result& result = results.emplace_back(Run(options, bench_case, setting, canvas));
+        // NOTE: Progress Goes To stderr, So stdout Holds Only The CSV.
+        fmt::fprintf(stderr, "%s %s Cull %d Clip %d: p50 %.1f us, p99 %.1f us\n", result.scene, ALGORITHM_NAMES[result.algorithm], (int)result.cull, (int)result.clip, result.p50, result.p99);
+      }
+    }
+  }
+
+  if (options.csv != nullptr)
+  {
+    Write(options.csv, results, WriteCSV);
+  }
+  if (options.json != nullptr)
+  {
+    Write(options.json, results, WriteJSON);
+  }
+  if (options.csv == nullptr && options.json == nullptr)
+  {
+    WriteCSV(stdout, results);
+  }
+
+  ThreadPool::ShutDown();
+
+  return 0;
+}
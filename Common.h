@@ -27,6 +27,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstdint>
+#include <bit>
 #include <bitset>
 #include <numeric>
 #include <list>
@@ -42,6 +43,7 @@
 #include <filesystem>
 #include <algorithm>
 #include <functional>
+#include <chrono>
 
 #define NODISCARD [[nodiscard]]
 #define NOEXCEPT noexcept
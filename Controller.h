@@ -17,6 +17,11 @@
 #include <Entity.h>
 #include <Shader.h>
 #include <Loader.h>
+#include <Rasterizer.h>
+#include <Pipeline.h>
+#include <Acceleration/HZBuffer.h>
+#include <RenderThread.h>
+#include <Profiler.h>
 
 extern Setting setting;
 extern Shader::Config config;
@@ -134,8 +139,158 @@ struct Controller
     ImGui::SetNextWindowDockID(dock_id);
     ImGui::Begin("Controller");
 
+    // NOTE: Statistics Are Those Of The Frame On Screen. The Render Thread's Own Are Being Written While This Runs.
+    const RenderThread::Frame& frame = RenderThread::Front();
+
     ImGui::Text("Frame Time(ms): %llu", frame_time);
+    {
+      const Rasterizer::Statistic& statistic = frame.rasterizer;
+      const double cells = (double)std::max(statistic.span_cells, (uint64_t)1);
+      ImGui::Text("Span Cells: %llu", statistic.span_cells);
+      ImGui::Text("Trivially Rejected: %.1f%%", 100.0 * (double)statistic.rejected_cells / cells);
+      ImGui::Text("Trivially Accepted: %.1f%%", 100.0 * (double)statistic.accepted_cells / cells);
+      if (frame.pipeline.covered_pixels != 0)
+      {
+        ImGui::Text("Overdraw: %.2f", (double)statistic.written_pixels / (double)frame.pipeline.covered_pixels);
+      }
+    }
+    if (setting.occlusion_prepass)
+    {
+      const Pipeline::Statistic& statistic = frame.pipeline;
+      ImGui::Text("Prepass Time(ms): %.3f", statistic.prepass_time);
+      ImGui::Text("Occluders: %u Models, %u Polygons", statistic.occluder_models, statistic.occluder_polygons);
+      ImGui::Text("Prepass Culled: %u / %u", statistic.prepass_culled, statistic.prepass_tested);
+    }
+    if (setting.algorithm == Setting::ScanConvertBVHHZBuffer)
+    {
+      const Pipeline::Statistic& statistic = frame.pipeline;
+      ImGui::Text("Models Drawn: %u / %zu", statistic.drawn_models, scene.models.size());
+      ImGui::Text("BVH Nodes Culled: %u / %u", statistic.culled_nodes, statistic.tested_nodes);
+    }
+
+    if (ImGui::CollapsingHeader("Work Counters"))
+    {
+      ImGui::Indent(10.0f);
+
+      // COMMENT: Where Polygons Leave The Pipeline, Then What The Z Pyramid, The Hierarchies And The Spans Cost. The Rasterizer Counters Stay 0 For The Interval Scan Line.
+      const Pipeline::Statistic& pipeline = frame.pipeline;
+      const Rasterizer::Statistic& rasterizer = frame.rasterizer;
+      const HZBuffer::Statistic& h_z_buffer = frame.h_z_buffer;
+      ImGui::Text("Polygons: %u", pipeline.input_polygons);
+      ImGui::Text("Back Face Culled: %u", pipeline.backface_culled);
+      ImGui::Text("Clipped: %u", pipeline.clipped_polygons);
+      ImGui::Text("Occluded: %llu", rasterizer.occluded_polygons);
+      ImGui::Text("Rasterized: %llu", rasterizer.rasterized_polygons);
+      ImGui::Text("ZBH Queries: %llu", h_z_buffer.queries);
+      ImGui::Text("ZBH Texels Read: %llu", h_z_buffer.read_texels);
+      ImGui::Text("ZBH Texels Rebuilt: %llu", h_z_buffer.rebuilt_texels);
+      ImGui::Text("HAABB Nodes Culled: %llu / %llu", rasterizer.haabb_culled, rasterizer.haabb_nodes);
+      ImGui::Text("Spans: %llu", rasterizer.spans);
+      ImGui::Text("Span Pixels: %llu", rasterizer.span_pixels);
+      ImGui::Text("Pixels Depth Tested: %llu", rasterizer.tested_pixels);
+      ImGui::Text("Pixels Written: %llu", rasterizer.written_pixels);
+
+      ImGui::Unindent(10.0f);
+    }
     
+#ifdef ENABLE_PROFILER
+    if (ImGui::CollapsingHeader("Profiler"))
+    {
+      ImGui::Indent(10.0f);
+
+      // COMMENT: Exclusive Milliseconds Per Stage Over The Last Frames, Summed Over Every Thread. The Overlay Is The Mean.
+      // NOTE: Read From The Frame On Screen, Since The Render Thread Appends To The Live History While This Runs.
+      float total = 0.0f;
+      for (int stage = 0; stage < Profiler::STAGE_COUNT; ++stage)
+      {
+        const float average = frame.profiler.averages[stage];
+        total += average;
+        ImGui::PlotLines(Profiler::Name((Profiler::Stage)stage), frame.profiler.history[stage], PROFILER_HISTORY, frame.profiler.offset,
+          fmt::sprintf("%.3f ms", average).c_str(), 0.0f, FLT_MAX, ImVec2(0.0f, 40.0f));
+      }
+      ImGui::Text("Instrumented Total(ms): %.3f", total);
+
+      // COMMENT: Chrome Trace Of The Next Frames, Written To trace.json In The Working Directory.
+      static int trace_frames = 30;
+      ImGui::InputInt("Trace Frames", &trace_frames);
+      trace_frames = std::clamp(trace_frames, 1, PROFILER_HISTORY);
+      if (Profiler::Capturing())
+      {
+        ImGui::Text("Capturing...");
+      }
+      else if (ImGui::Button("Capture Trace"))
+      {
+        Profiler::Capture(trace_frames, "trace.json");
+      }
+
+      // COMMENT: Hardware Counters Per Stage, Averaged Per Frame Over The Counted Frames. Exclusive Like The Times.
+      bool counters = Profiler::CountersEnabled();
+      if (ImGui::Checkbox("Hardware Counters", &counters))
+      {
+        Profiler::EnableCounters(counters);
+      }
+      if (counters)
+      {
+        const uint32_t available = Profiler::CountersAvailable();
+        if (available == 0)
+        {
+          ImGui::TextDisabled("Unavailable: No PMU Or perf_event_paranoid Too High");
+        }
+        else if (ImGui::BeginTable("Counters", 2 + Profiler::COUNTER_COUNT, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit))
+        {
+          const bool ipc = (available & (1u << Profiler::CYCLES)) && (available & (1u << Profiler::INSTRUCTIONS));
+          ImGui::TableSetupColumn("Stage");
+          ImGui::TableSetupColumn("IPC");
+          for (int counter = 0; counter < Profiler::COUNTER_COUNT; ++counter)
+          {
+            ImGui::TableSetupColumn(Profiler::Name((Profiler::Counter)counter));
+          }
+          ImGui::TableHeadersRow();
+
+          // NOTE: The Last Row Is The Sum Over Every Stage.
+          for (int stage = 0; stage <= Profiler::STAGE_COUNT; ++stage)
+          {
+            double counts[Profiler::COUNTER_COUNT] = {};
+            for (int s = 0; s < Profiler::STAGE_COUNT; ++s)
+            {
+              for (int counter = 0; counter < Profiler::COUNTER_COUNT && (s == stage || stage == Profiler::STAGE_COUNT); ++counter)
+              {
+                counts[counter] += frame.profiler.counter_averages[s][counter];
+              }
+            }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", stage == Profiler::STAGE_COUNT ? "Total" : Profiler::Name((Profiler::Stage)stage));
+            ImGui::TableNextColumn();
+            if (ipc && counts[Profiler::CYCLES] > 0.0)
+            {
+              ImGui::Text("%.2f", counts[Profiler::INSTRUCTIONS] / counts[Profiler::CYCLES]);
+            }
+            else
+            {
+              ImGui::TextDisabled("-");
+            }
+            for (int counter = 0; counter < Profiler::COUNTER_COUNT; ++counter)
+            {
+              ImGui::TableNextColumn();
+              if (available & (1u << counter))
+              {
+                ImGui::Text("%.3fM", counts[counter] * 1e-6);
+              }
+              else
+              {
+                ImGui::TextDisabled("-");
+              }
+            }
+          }
+          ImGui::EndTable();
+        }
+      }
+
+      ImGui::Unindent(10.0f);
+    }
+#endif
+
     if (ImGui::CollapsingHeader("Help", ImGuiTreeNodeFlags_DefaultOpen))
     {
       ImGui::Indent(10.0f);
@@ -160,16 +315,30 @@ struct Controller
       ImGui::Checkbox("Show AABB", &setting.show_aabb);
       ImGui::Checkbox("Show Normal", &setting.show_normal);
       ImGui::Checkbox("Show ZBuffer", &setting.show_z_buffer);
+      ImGui::Checkbox("Show Overdraw", &setting.show_overdraw);
+      ImGui::Checkbox("Count Overdraw", &setting.count_overdraw);
       ImGui::Checkbox("Enable Cull", &setting.enable_cull);
       ImGui::Checkbox("Enable Clip", &setting.enable_clip);
+      ImGui::Checkbox("Enable Parallel", &setting.enable_parallel);
+      ImGui::Checkbox("Front To Back", &setting.enable_sort);
+      ImGui::Checkbox("Occlusion Prepass", &setting.occlusion_prepass);
       {
         static const char* const items[] = {
           "Scan Convert ZBuffer",
           "Scan Convert Hierarchical ZBuffer",
           "Scan Convert Hierarchical AABB Hierarchical ZBuffer",
           "Interval ScanLine",
+          "Scan Convert Scene BVH Hierarchical ZBuffer",
         };
-        ImGui::Combo("Algorithm", (int*)&setting.algorithm, items, 4);
+        ImGui::Combo("Algorithm", (int*)&setting.algorithm, items, 5);
+      }
+      if (setting.algorithm == Setting::ScanConvertHAABBHZBuffer)
+      {
+        ImGui::Checkbox("Screen Space HAABB", &setting.screen_haabb);
+      }
+      if ((setting.algorithm == Setting::ScanConvertHAABBHZBuffer && !setting.screen_haabb) || setting.algorithm == Setting::ScanConvertBVHHZBuffer)
+      {
+        ImGui::Checkbox("Temporal Occlusion", &setting.temporal_culling);
       }
       {
         static const char* const items[] = {
@@ -178,6 +347,39 @@ struct Controller
         };
         ImGui::Combo("DisplayMode", (int*)&setting.display_mode, items, 2);
       }
+      {
+        static const char* const items[] = {
+          "Immediate",
+          "Batched",
+          "On Demand",
+          "Deferred",
+        };
+        ImGui::Combo("Update Policy", (int*)&setting.update_policy, items, 4);
+      }
+      if (setting.update_policy == Setting::BATCHED)
+      {
+        ImGui::SliderInt("Batch Size", &setting.batch_size, 1, 1024);
+      }
+      ImGui::Checkbox("Dynamic Resolution", &setting.dynamic_resolution);
+      if (setting.dynamic_resolution)
+      {
+        ImGui::SliderFloat("Frame Budget(ms)", &setting.frame_budget, 1.0f, 100.0f, "%.1f");
+      }
+      else
+      {
+        ImGui::SliderFloat("Render Scale", &setting.render_scale, MIN_RENDER_SCALE, 1.0f, "%.2f");
+      }
+      {
+        static const char* const items[] = {
+          "Nearest",
+          "Bilinear",
+        };
+        ImGui::Combo("Upscale Filter", (int*)&setting.upscale_filter, items, 2);
+      }
+      {
+        const RenderThread::Frame& frame = RenderThread::Front();
+        ImGui::Text("Render Size: %d x %d (%.0f%%)", frame.frame_buffer.width, frame.frame_buffer.height, frame.scale * 100.0f);
+      }
 
       ImGui::Unindent(10.0f);
     }
@@ -314,6 +516,18 @@ struct Controller
           selected_model = &model;
           selected = i;
         }
+        if (const auto query = frame.visible_pixels.find(&model); query != frame.visible_pixels.end())
+        {
+          ImGui::SameLine();
+          if (query->second == 0)
+          {
+            ImGui::TextDisabled("Occluded");
+          }
+          else
+          {
+            ImGui::TextDisabled("%llu Pixels", query->second);
+          }
+        }
         ImGui::PopID();
         ++i;
       }
@@ -13,6 +13,9 @@
 #include <Entity.h>
 #include <Loader.h>
 
+// COMMENT: Share Of The Tiles Past Which Display Updates The Whole Window Instead Of Rects.
+CONSTEXPR float FULL_PRESENT = 0.5f;
+
 NODISCARD  Vertex Polygon::Center(const std::vector<Vertex>& vertices, const Polygon& polygon) NOEXCEPT
 {
   return std::accumulate(polygon.vertices.begin(), polygon.vertices.end(), Vertex(0.0f), [&](const Vertex& acc, const uint32_t vertex) -> Vertex {
@@ -71,6 +74,77 @@ NODISCARD  Model Model::FromObj(const char* filename) NOEXCEPT
   return model;
 }
 
+void Model::BuildEdges(Model& model) NOEXCEPT
+{
+  struct HalfEdge
+  {
+    uint32_t v0;
+    uint32_t v1;
+    uint32_t pid;
+  };
+
+  std::vector<HalfEdge> half_edges;
+  half_edges.reserve(model.indices.size());
+
+  for (size_t i = 0, j = 0; i < model.polygon_sides.size() && j < model.indices.size(); j += model.polygon_sides[i], ++i)
+  {
+    const uint32_t sides = model.polygon_sides[i];
+    if (sides < 2) { continue; }
+    // COMMENT: A Two Sided Polygon Is A Single Line, Not A Closed Loop.
+    for (uint32_t k = 0; k < (sides == 2 ? 1 : sides); ++k)
+    {
+      const uint32_t a = model.indices[j + k].vertex;
+      const uint32_t b = model.indices[j + (k + 1) % sides].vertex;
+      if (a == b) { continue; }
+      half_edges.push_back({std::min(a, b), std::max(a, b), (uint32_t)i});
+    }
+  }
+
+  std::sort(half_edges.begin(), half_edges.end(), [](const HalfEdge& lhs, const HalfEdge& rhs) NOEXCEPT
+  {
+    return lhs.v0 != rhs.v0 ? lhs.v0 < rhs.v0 : lhs.v1 != rhs.v1 ? lhs.v1 < rhs.v1 : lhs.pid < rhs.pid;
+  });
+
+  model.edges.clear();
+  model.edges.reserve(half_edges.size() / 2 + 1);
+
+  // COMMENT: Pair Up Polygons Sharing An Edge. Non Manifold Edges Keep Every Extra Polygon On Its Own Edge.
+  for (size_t i = 0; i < half_edges.size();)
+  {
+    size_t j = i + 1;
+    while (j < half_edges.size() && half_edges[j].v0 == half_edges[i].v0 && half_edges[j].v1 == half_edges[i].v1) { ++j; }
+    for (size_t k = i; k < j; k += 2)
+    {
+      model.edges.push_back({half_edges[k].v0, half_edges[k].v1, half_edges[k].pid, k + 1 < j ? half_edges[k + 1].pid : (uint32_t)-1});
+    }
+    i = j;
+  }
+
+  model.edges.shrink_to_fit();
+}
+
+void Model::BuildBVH(Model& model) NOEXCEPT
+{
+  // NOTE: Small Leaves Keep Culling Fine Grained, While Sharing One Node Test Among A Few Polygons.
+  CONSTEXPR uint32_t LEAF_SIZE = 4;
+
+  std::vector<AABB> aabbs(model.polygon_sides.size());
+  for (size_t i = 0, j = 0; i < model.polygon_sides.size() && j < model.indices.size(); j += model.polygon_sides[i], ++i)
+  {
+    // COMMENT: A Polygon Without Vertices Keeps An Empty Box At The Origin, So Its Center Stays Finite.
+    if (model.polygon_sides[i] == 0) { continue; }
+    aabbs[i].vmin = glm::vec3(INF), aabbs[i].vmax = glm::vec3(-INF);
+    for (uint32_t k = 0; k < model.polygon_sides[i]; ++k)
+    {
+      aabbs[i].vmin = glm::min(aabbs[i].vmin, model.vertices[model.indices[j + k].vertex]);
+      aabbs[i].vmax = glm::max(aabbs[i].vmax, model.vertices[model.indices[j + k].vertex]);
+    }
+  }
+
+  BVH::Build(model.bvh, aabbs.data(), (uint32_t)aabbs.size(), LEAF_SIZE);
+  model.bvh.nodes.shrink_to_fit();
+}
+
 NODISCARD  FrameBuffer FrameBuffer::From(SDL_Window* window, const Color& bgc) NOEXCEPT
 {
   FrameBuffer frame_buffer;
@@ -80,188 +154,395 @@ NODISCARD  FrameBuffer FrameBuffer::From(SDL_Window* window, const Color& bgc) N
   frame_buffer.width = frame_buffer.surface->w;
   frame_buffer.height = frame_buffer.surface->h;
   frame_buffer.bgc = bgc;
+  frame_buffer.mapped_bgc = SDL_MapRGB(
+    frame_buffer.format, nullptr,
+    (Uint8)(255.999f * std::clamp(bgc.r, 0.0f, 1.0f)),
+    (Uint8)(255.999f * std::clamp(bgc.g, 0.0f, 1.0f)),
+    (Uint8)(255.999f * std::clamp(bgc.b, 0.0f, 1.0f))
+  );
   frame_buffer.buffer = (Uint32*)frame_buffer.surface->pixels;
+
+  // COMMENT: The Whole Surface Starts As Background, But Has Never Been Presented. Every Tile Starts At Epoch 1, So The First Display Updates All Of It.
+  frame_buffer.tile_cols = (frame_buffer.width + TILE_SIZE - 1) >> TILE_SHIFT;
+  frame_buffer.tile_rows = (frame_buffer.height + TILE_SIZE - 1) >> TILE_SHIFT;
+  frame_buffer.epoch = 1;
+  frame_buffer.tile_epochs = new uint32_t[frame_buffer.tile_cols * frame_buffer.tile_rows];
+  std::fill_n(frame_buffer.tile_epochs, frame_buffer.tile_cols * frame_buffer.tile_rows, 1);
+  frame_buffer.rects = new SDL_Rect[frame_buffer.tile_cols * frame_buffer.tile_rows];
+  SDL_ClearSurface(frame_buffer.surface, bgc.r, bgc.g, bgc.b, 0.0f);
+
   return frame_buffer;
 }
 
- void FrameBuffer::Display(const FrameBuffer& frame_buffer) NOEXCEPT
+NODISCARD  FrameBuffer FrameBuffer::From(const int width, const int height, const SDL_PixelFormat format, const Color& bgc) NOEXCEPT
 {
-  SDL_UpdateWindowSurface(frame_buffer.window);
-}
+  ASSERT(width > 0 && height > 0);
 
- void FrameBuffer::Clear(const FrameBuffer& frame_buffer) NOEXCEPT
-{
-  SDL_ClearSurface(frame_buffer.surface, frame_buffer.bgc.r, frame_buffer.bgc.g, frame_buffer.bgc.b, 0.0f);
+  FrameBuffer frame_buffer;
+  frame_buffer.format = SDL_GetPixelFormatDetails(format);
+  if (frame_buffer.format == nullptr || frame_buffer.format->bytes_per_pixel != sizeof(Uint32))
+  {
+    Fatal("Unsupported Pixel Format! %s\n", SDL_GetError());
+  }
+  frame_buffer.width = width;
+  frame_buffer.height = height;
+  frame_buffer.bgc = bgc;
+  frame_buffer.mapped_bgc = SDL_MapRGB(
+    frame_buffer.format, nullptr,
+    (Uint8)(255.999f * std::clamp(bgc.r, 0.0f, 1.0f)),
+    (Uint8)(255.999f * std::clamp(bgc.g, 0.0f, 1.0f)),
+    (Uint8)(255.999f * std::clamp(bgc.b, 0.0f, 1.0f))
+  );
+
+  // NOTE: Cache Line Aligned, As The Span Kernels Prefer.
+  frame_buffer.buffer = (Uint32*)SDL_aligned_alloc(64, sizeof(Uint32) * width * height);
+  if (frame_buffer.buffer == nullptr)
+  {
+    Fatal("Can Not Allocate Frame Buffer!\n");
+  }
+  std::fill_n(frame_buffer.buffer, width * height, frame_buffer.mapped_bgc);
+
+  frame_buffer.tile_cols = (frame_buffer.width + TILE_SIZE - 1) >> TILE_SHIFT;
+  frame_buffer.tile_rows = (frame_buffer.height + TILE_SIZE - 1) >> TILE_SHIFT;
+  frame_buffer.epoch = 1;
+  frame_buffer.tile_epochs = new uint32_t[frame_buffer.tile_cols * frame_buffer.tile_rows];
+  std::fill_n(frame_buffer.tile_epochs, frame_buffer.tile_cols * frame_buffer.tile_rows, 0);
+
+  return frame_buffer;
 }
 
-NODISCARD  ZBuffer ZBuffer::From(const FrameBuffer& frame_buffer, const float bgz) NOEXCEPT
+NODISCARD  Uint32 FrameBuffer::Pixel(const FrameBuffer& frame_buffer, const int x, const int y) NOEXCEPT
 {
-  ZBuffer z_buffer;
-  z_buffer.width = frame_buffer.width;
-  z_buffer.height = frame_buffer.height;
-  z_buffer.bgz = bgz;
-  z_buffer.buffer = new float*[z_buffer.height];
-  for (int i = 0; i < z_buffer.height; ++i)
+  const uint32_t tile_epoch = frame_buffer.tile_epochs[(y >> TILE_SHIFT) * frame_buffer.tile_cols + (x >> TILE_SHIFT)];
+  if (tile_epoch != 0 && tile_epoch != frame_buffer.epoch)
   {
-    z_buffer.buffer[i] = new float[z_buffer.width];
+    return frame_buffer.mapped_bgc;
   }
-  return z_buffer;
+  return frame_buffer.buffer[frame_buffer.width * y + x];
 }
 
- void ZBuffer::Clear(const ZBuffer& z_buffer) NOEXCEPT
+ void FrameBuffer::Display(const FrameBuffer& frame_buffer) NOEXCEPT
 {
-  for (int i = 0; i < z_buffer.height; ++i)
+  // COMMENT: Tiles Drawn Last Frame But Not This Frame Still Hold Stale Pixels. Reset Them To Background.
+  // COMMENT: Every Tile Not At Epoch 0 Was Drawn In One Of The Two Frames. Each Run Of Them In A Tile Row Becomes One Rect.
+  int count = 0;
+  int dirty = 0;
+  for (int ty = 0; ty < frame_buffer.tile_rows; ++ty)
   {
-    for (int j = 0; j < z_buffer.width; ++j)
+    int run = -1;
+    for (int tx = 0; tx <= frame_buffer.tile_cols; ++tx)
     {
-      z_buffer.buffer[i][j] = z_buffer.bgz;
+      bool drawn = false;
+      if (tx < frame_buffer.tile_cols)
+      {
+        uint32_t& tile_epoch = frame_buffer.tile_epochs[ty * frame_buffer.tile_cols + tx];
+        drawn = tile_epoch != 0;
+        if (tile_epoch != 0 && tile_epoch != frame_buffer.epoch)
+        {
+          FillTile(frame_buffer, tx, ty);
+          tile_epoch = 0;
+        }
+      }
+      if (drawn && run < 0)
+      {
+        run = tx;
+      }
+      else if (!drawn && run >= 0)
+      {
+        if (frame_buffer.rects != nullptr)
+        {
+          const int x = run << TILE_SHIFT;
+          const int y = ty << TILE_SHIFT;
+          frame_buffer.rects[count++] = SDL_Rect{ .x = x, .y = y, .w = std::min(tx << TILE_SHIFT, frame_buffer.width) - x, .h = std::min(y + TILE_SIZE, frame_buffer.height) - y };
+        }
+        dirty += tx - run;
+        run = -1;
+      }
     }
   }
-}
-
-NODISCARD std::vector<ZBH> ZBH::From(const Canvas& canvas) NOEXCEPT
-{
-    std::vector<ZBH> zbh_tree;
-
-    zbh_tree.resize((Pow4(Log2(std::max(canvas.width, canvas.height)) + 1) - 1) / 3);
-
-    int front = 0, rear = 0;
-    static int* que = new int[zbh_tree.size()];
-
-    const float bgz = canvas.z_buffer->bgz;
-    
-    zbh_tree[0] = ZBH
+  if (frame_buffer.window != nullptr)
+  {
+    // NOTE: Past FULL_PRESENT Of The Tiles, One Whole Update Costs Less Than Many Small Ones.
+    if (dirty >= FULL_PRESENT * (float)(frame_buffer.tile_cols * frame_buffer.tile_rows))
     {
-        .valid = true,
-        .zmax  = bgz,
-        .xmin  = 0,
-        .xmax  = canvas.width-1,
-        .ymin  = 0,
-        .ymax  = canvas.height-1,
-    };
-
-    if (zbh_tree[0].xmin == zbh_tree[0].xmax && zbh_tree[0].ymin == zbh_tree[0].ymax)
+      SDL_UpdateWindowSurface(frame_buffer.window);
+    }
+    else if (count != 0)
     {
-        return zbh_tree;
+      SDL_UpdateWindowSurfaceRects(frame_buffer.window, frame_buffer.rects, count);
     }
+  }
+}
 
-    que[rear++] = 0;
-
-    while(front < rear)
+ void FrameBuffer::Clear(FrameBuffer& frame_buffer) NOEXCEPT
+{
+  // NOTE: Nothing Is Written Here. Tiles Are Cleared On Their First Touch Or At Display.
+  if (++frame_buffer.epoch == 0)
+  {
+    for (int i = 0; i < frame_buffer.tile_cols * frame_buffer.tile_rows; ++i)
     {
-        const int cur = que[front++];
-        const int xmin = zbh_tree[cur].xmin;
-        const int xmax = zbh_tree[cur].xmax;
-        const int ymin = zbh_tree[cur].ymin;
-        const int ymax = zbh_tree[cur].ymax;
-        const int xmid = (xmin + xmax) >> 1; 
-        const int ymid = (ymin + ymax) >> 1; 
-
-        for (int i = Child0(cur), j = 0; i <= Child3(cur) && (size_t)i < zbh_tree.size(); ++i, ++j)
-        {
-            zbh_tree[i].xmin = j & 1 ? xmid + 1 : xmin;
-            zbh_tree[i].xmax = j & 1 ? xmax : xmid;
-            zbh_tree[i].ymin = j & 2 ? ymid + 1 : ymin;
-            zbh_tree[i].ymax = j & 2 ? ymax : ymid;
-            zbh_tree[i].valid = true;
-            zbh_tree[i].zmax = bgz;
-            if (!(zbh_tree[i].xmin == zbh_tree[i].xmax && zbh_tree[i].ymin == zbh_tree[i].ymax))
-            {
-                que[rear++] = i;
-            }
-        }
+      if (frame_buffer.tile_epochs[i] != 0)
+      {
+        frame_buffer.tile_epochs[i] = 1;
+      }
     }
-    
-    return zbh_tree;
+    frame_buffer.epoch = 2;
+  }
 }
 
-// ReSharper disable once CppParameterMayBeConstPtrOrRef
-void ZBH::Clear(std::vector<ZBH>& zbh_tree, Canvas& canvas) NOEXCEPT
+ void FrameBuffer::Copy(const FrameBuffer& frame_buffer, const FrameBuffer& source) NOEXCEPT
 {
-    const float bgz = canvas.z_buffer->bgz;
-    for (auto& zbh : zbh_tree)
+  ASSERT(frame_buffer.width == source.width && frame_buffer.height == source.height && frame_buffer.format == source.format);
+
+  // COMMENT: Each Run Of Drawn Tiles In A Tile Row Is Copied A Pixel Row At A Time, So Wide Models Copy Long Rows Rather Than Many Short Ones.
+  for (int ty = 0; ty < source.tile_rows; ++ty)
+  {
+    const int ymin = ty << TILE_SHIFT;
+    const int ymax = std::min(ymin + TILE_SIZE, source.height);
+    int tx = 0;
+    while (tx < source.tile_cols)
     {
-        zbh.zmax = bgz;
+      if (source.tile_epochs[ty * source.tile_cols + tx] == 0)
+      {
+        ++tx;
+        continue;
+      }
+      const int run = tx;
+      while (tx < source.tile_cols && source.tile_epochs[ty * source.tile_cols + tx] != 0)
+      {
+        frame_buffer.tile_epochs[ty * frame_buffer.tile_cols + tx] = frame_buffer.epoch;
+        ++tx;
+      }
+      const int xmin = run << TILE_SHIFT;
+      const int xmax = std::min(tx << TILE_SHIFT, source.width);
+      for (int y = ymin; y < ymax; ++y)
+      {
+        std::copy(source.buffer + source.width * y + xmin, source.buffer + source.width * y + xmax, frame_buffer.buffer + frame_buffer.width * y + xmin);
+      }
     }
+  }
 }
 
-NODISCARD float ZBH::Query(const std::vector<ZBH>& zbh_tree, const int xmin, const int xmax, const int ymin, const int ymax) NOEXCEPT
+ void FrameBuffer::Upscale(const FrameBuffer& frame_buffer, const FrameBuffer& source, const bool bilinear) NOEXCEPT
 {
-    ASSERT(!zbh_tree.empty());
-
-    float zmax = -INF;
+  ASSERT(frame_buffer.format == source.format);
 
-    int front = 0, rear = 0;
-    static int* que = new int[zbh_tree.size()];
+  // COMMENT: Source Coordinates Of Pixel Centers In 16.16 Fixed Point. Pixel x Maps To (x + 0.5) * source.width / width - 0.5.
+  const int64_t sx = ((int64_t)source.width << 16) / frame_buffer.width;
+  const int64_t sy = ((int64_t)source.height << 16) / frame_buffer.height;
+  auto Center = [](const int64_t step, const int i) NOEXCEPT -> int64_t
+  {
+    return std::max(step * i + (step >> 1) - (1 << 15), (int64_t)0);
+  };
 
-    que[rear++] = 0;
-    
-    while(front < rear)
-    {
-        const int cur = que[front++];
+  // COMMENT: Blend Two Packed Pixels By a / 256, Two Channels At A Time.
+  auto Lerp = [](const Uint32 p, const Uint32 q, const Uint32 a) NOEXCEPT -> Uint32
+  {
+    const Uint32 rb = (((p & 0x00FF00FFu) * (256u - a) + (q & 0x00FF00FFu) * a) >> 8) & 0x00FF00FFu;
+    const Uint32 ag = (((p >> 8) & 0x00FF00FFu) * (256u - a) + ((q >> 8) & 0x00FF00FFu) * a) & 0xFF00FF00u;
+    return rb | ag;
+  };
 
-        ASSERT(zbh_tree[cur].valid);
+  static std::vector<int>    x0s; x0s.resize(frame_buffer.width);
+  static std::vector<int>    x1s; x1s.resize(frame_buffer.width);
+  static std::vector<Uint32> wxs; wxs.resize(frame_buffer.width);
+  for (int x = 0; x < frame_buffer.width; ++x)
+  {
+    const int64_t fx = bilinear ? Center(sx, x) : sx * x + (sx >> 1);
+    x0s[x] = std::min((int)(fx >> 16), source.width - 1);
+    x1s[x] = std::min(x0s[x] + 1, source.width - 1);
+    wxs[x] = (Uint32)(fx >> 8) & 0xFFu;
+  }
 
-        if (xmin <= zbh_tree[cur].xmin && zbh_tree[cur].xmax <= xmax && ymin <= zbh_tree[cur].ymin && zbh_tree[cur].ymax <= ymax)
+  if (!bilinear)
+  {
+    for (int y = 0; y < frame_buffer.height; ++y)
+    {
+      const Uint32* row = source.buffer + source.width * std::min((int)((sy * y + (sy >> 1)) >> 16), source.height - 1);
+      Uint32* out = frame_buffer.buffer + frame_buffer.width * y;
+      for (int x = 0; x < frame_buffer.width; ++x)
+      {
+        out[x] = row[x0s[x]];
+      }
+    }
+  }
+  else
+  {
+    // COMMENT: Source Rows Are Blended Horizontally Once Each, Then Every Output Row Between Them Only Blends Vertically.
+    static std::vector<Uint32> top;    top.resize(frame_buffer.width);
+    static std::vector<Uint32> bottom; bottom.resize(frame_buffer.width);
+    auto Blend = [&](const int y, std::vector<Uint32>& blended) NOEXCEPT -> void
+    {
+      const Uint32* row = source.buffer + source.width * y;
+      for (int x = 0; x < frame_buffer.width; ++x)
+      {
+        blended[x] = Lerp(row[x0s[x]], row[x1s[x]], wxs[x]);
+      }
+    };
+    int y0 = -1;
+    int y1 = -1;
+    for (int y = 0; y < frame_buffer.height; ++y)
+    {
+      const int64_t fy = Center(sy, y);
+      const int r0 = std::min((int)(fy >> 16), source.height - 1);
+      const int r1 = std::min(r0 + 1, source.height - 1);
+      if (r0 != y0)
+      {
+        if (r0 == y1)
         {
-            zmax = std::max(zmax, zbh_tree[cur].zmax);
-            continue;
+          top.swap(bottom);
         }
-
-        for (int i = Child0(cur); i <= Child3(cur) && (size_t)i < zbh_tree.size(); ++i)
+        else
         {
-            if (zbh_tree[i].valid && xmin <= zbh_tree[i].xmax && zbh_tree[i].xmin <= xmax && ymin <= zbh_tree[i].ymax && zbh_tree[i].ymin <= ymax)
-            {
-                que[rear++] = i;
-            }
+          Blend(r0, top);
         }
+        Blend(r1, bottom);
+        y0 = r0;
+        y1 = r1;
+      }
+      const Uint32 wy = (Uint32)(fy >> 8) & 0xFFu;
+      Uint32* out = frame_buffer.buffer + frame_buffer.width * y;
+      for (int x = 0; x < frame_buffer.width; ++x)
+      {
+        out[x] = Lerp(top[x], bottom[x], wy);
+      }
     }
+  }
 
-    ASSERT(zmax != -INF);
-    
-    return zmax;
+  std::fill_n(frame_buffer.tile_epochs, frame_buffer.tile_cols * frame_buffer.tile_rows, frame_buffer.epoch);
 }
 
-void ZBH::Update(std::vector<ZBH>& zbh_tree, Canvas& canvas, const int xmin, const int xmax, const int ymin, const int ymax) NOEXCEPT
+ void FrameBuffer::Destroy(FrameBuffer& frame_buffer) NOEXCEPT
 {
-    ASSERT(!zbh_tree.empty());
-
-    int top = 0;
-    static int* stk = new int[zbh_tree.size()];
+  if (frame_buffer.window == nullptr)
+  {
+    SDL_aligned_free(frame_buffer.buffer);
+  }
+  delete[] frame_buffer.tile_epochs;
+  delete[] frame_buffer.rects;
+  frame_buffer = {};
+}
 
-    stk[top++] = 0;
+ void FrameBuffer::FillTile(const FrameBuffer& frame_buffer, const int tx, const int ty) NOEXCEPT
+{
+  const int xmin = tx << TILE_SHIFT;
+  const int xmax = std::min(xmin + TILE_SIZE, frame_buffer.width);
+  const int ymin = ty << TILE_SHIFT;
+  const int ymax = std::min(ymin + TILE_SIZE, frame_buffer.height);
+  for (int y = ymin; y < ymax; ++y)
+  {
+    std::fill(frame_buffer.buffer + frame_buffer.width * y + xmin, frame_buffer.buffer + frame_buffer.width * y + xmax, frame_buffer.mapped_bgc);
+  }
+}
 
-    for (int cur = 0; cur < top; ++cur)
+ void FrameBuffer::Touch(const FrameBuffer& frame_buffer, const int xmin, const int xmax, const int ymin, const int ymax) NOEXCEPT
+{
+  const int txmin = std::max(xmin, 0) >> TILE_SHIFT;
+  const int txmax = std::min(xmax, frame_buffer.width - 1) >> TILE_SHIFT;
+  const int tymin = std::max(ymin, 0) >> TILE_SHIFT;
+  const int tymax = std::min(ymax, frame_buffer.height - 1) >> TILE_SHIFT;
+  for (int ty = tymin; ty <= tymax; ++ty)
+  {
+    for (int tx = txmin; tx <= txmax; ++tx)
     {
-        ASSERT(zbh_tree[cur].valid);
+      Touch(frame_buffer, tx, ty);
+    }
+  }
+}
 
-        for (int i = Child0(cur), j = 0; i <= Child3(cur) && (size_t)i < zbh_tree.size(); ++i, ++j)
-        {
-            if (zbh_tree[i].valid && xmin <= zbh_tree[i].xmax && zbh_tree[i].xmin <= xmax && ymin <= zbh_tree[i].ymax && zbh_tree[i].ymin <= ymax)
-            {
-                stk[top++] = i;
-            }
-        }
+NODISCARD  ZBuffer ZBuffer::From(const FrameBuffer& frame_buffer, const float bgz) NOEXCEPT
+{
+  ZBuffer z_buffer;
+  z_buffer.width = frame_buffer.width;
+  z_buffer.height = frame_buffer.height;
+  z_buffer.bgz = bgz;
+  z_buffer.buffer = new float*[z_buffer.height];
+  for (int i = 0; i < z_buffer.height; ++i)
+  {
+    z_buffer.buffer[i] = new float[z_buffer.width];
+  }
+  z_buffer.tile_cols = (z_buffer.width + TILE_SIZE - 1) >> TILE_SHIFT;
+  z_buffer.tile_rows = (z_buffer.height + TILE_SIZE - 1) >> TILE_SHIFT;
+  z_buffer.epoch = 1;
+  z_buffer.tile_epochs = new uint32_t[z_buffer.tile_cols * z_buffer.tile_rows];
+  std::fill_n(z_buffer.tile_epochs, z_buffer.tile_cols * z_buffer.tile_rows, 0);
+  z_buffer.cell_cols = (z_buffer.width + CELL_SIZE - 1) >> CELL_SHIFT;
+  z_buffer.cell_rows = (z_buffer.height + CELL_SIZE - 1) >> CELL_SHIFT;
+  z_buffer.zmin = new float[z_buffer.cell_cols * z_buffer.cell_rows];
+  z_buffer.zmax = new float[z_buffer.cell_cols * z_buffer.cell_rows];
+  z_buffer.row_zmax = new float[z_buffer.cell_cols * z_buffer.cell_rows * CELL_SIZE];
+  z_buffer.row_hit = new uint8_t[z_buffer.cell_cols * z_buffer.cell_rows * CELL_SIZE];
+  z_buffer.stale = new uint8_t[z_buffer.cell_cols * z_buffer.cell_rows];
+  return z_buffer;
+}
+
+ void ZBuffer::Clear(ZBuffer& z_buffer) NOEXCEPT
+{
+  // NOTE: Nothing Is Written Here. Tiles Are Cleared On Their First Depth Test.
+  if (++z_buffer.epoch == 0)
+  {
+    std::fill_n(z_buffer.tile_epochs, z_buffer.tile_cols * z_buffer.tile_rows, 0);
+    z_buffer.epoch = 1;
+  }
+}
+
+ void ZBuffer::Destroy(ZBuffer& z_buffer) NOEXCEPT
+{
+  for (int i = 0; i < z_buffer.height; ++i)
+  {
+    delete[] z_buffer.buffer[i];
+  }
+  delete[] z_buffer.buffer;
+  delete[] z_buffer.tile_epochs;
+  delete[] z_buffer.zmin;
+  delete[] z_buffer.zmax;
+  delete[] z_buffer.row_zmax;
+  delete[] z_buffer.row_hit;
+  delete[] z_buffer.stale;
+  z_buffer = {};
+}
+
+ void ZBuffer::FillTile(const ZBuffer& z_buffer, const int tx, const int ty) NOEXCEPT
+{
+  const int xmin = tx << TILE_SHIFT;
+  const int xmax = std::min(xmin + TILE_SIZE, z_buffer.width);
+  const int ymin = ty << TILE_SHIFT;
+  const int ymax = std::min(ymin + TILE_SIZE, z_buffer.height);
+  for (int y = ymin; y < ymax; ++y)
+  {
+    std::fill(z_buffer.buffer[y] + xmin, z_buffer.buffer[y] + xmax, z_buffer.bgz);
+  }
+  for (int cy = ymin >> CELL_SHIFT; cy < (ymax + CELL_SIZE - 1) >> CELL_SHIFT; ++cy)
+  {
+    for (int cx = xmin >> CELL_SHIFT; cx < (xmax + CELL_SIZE - 1) >> CELL_SHIFT; ++cx)
+    {
+      z_buffer.zmin[cy * z_buffer.cell_cols + cx] = z_buffer.bgz;
+      z_buffer.zmax[cy * z_buffer.cell_cols + cx] = z_buffer.bgz;
+      z_buffer.stale[cy * z_buffer.cell_cols + cx] = 0;
+      // NOTE: Rows Past The Bottom Edge Take -INF, So They Never Hold Up zmax.
+      float* rows = z_buffer.row_zmax + ((cy * z_buffer.cell_cols + cx) << CELL_SHIFT);
+      for (int i = 0; i < CELL_SIZE; ++i)
+      {
+        rows[i] = (cy << CELL_SHIFT) + i < z_buffer.height ? z_buffer.bgz : -INF;
+      }
+      std::fill_n(z_buffer.row_hit + ((cy * z_buffer.cell_cols + cx) << CELL_SHIFT), CELL_SIZE, 0);
     }
+  }
+}
 
-    while(top--)
+ void ZBuffer::Touch(const ZBuffer& z_buffer, const int xmin, const int xmax, const int ymin, const int ymax) NOEXCEPT
+{
+  const int txmin = std::max(xmin, 0) >> TILE_SHIFT;
+  const int txmax = std::min(xmax, z_buffer.width - 1) >> TILE_SHIFT;
+  const int tymin = std::max(ymin, 0) >> TILE_SHIFT;
+  const int tymax = std::min(ymax, z_buffer.height - 1) >> TILE_SHIFT;
+  for (int ty = tymin; ty <= tymax; ++ty)
+  {
+    for (int tx = txmin; tx <= txmax; ++tx)
     {
-        const int cur = stk[top];
-        if (zbh_tree[cur].xmin == zbh_tree[cur].xmax && zbh_tree[cur].ymin == zbh_tree[cur].ymax)
-        {
-            zbh_tree[cur].zmax = canvas.z_buffer->buffer[zbh_tree[cur].ymin][zbh_tree[cur].xmin];
-            continue;
-        }
-        zbh_tree[cur].zmax = -INF;
-        for (int i = Child0(cur); i <= Child3(cur) && (size_t)i < zbh_tree.size(); ++i)
-        {
-            if (zbh_tree[i].valid)
-            {
-                zbh_tree[cur].zmax = std::max(zbh_tree[cur].zmax, zbh_tree[i].zmax);
-            }
-        }
-        ASSERT(zbh_tree[cur].zmax != -INF);
+      Touch(z_buffer, tx, ty);
     }
+  }
 }
 
 NODISCARD  Canvas Canvas::From(FrameBuffer& frame_buffer, ZBuffer& z_buffer, const int offsetx, const int offsety, const int width, const int height) NOEXCEPT
@@ -14,6 +14,7 @@
 #define ENTITY_H
 
 #include <Common.h>
+#include <Acceleration/BVH.h>
 
 using Color = glm::vec3;
 using Vertex = glm::vec3;
@@ -40,6 +41,10 @@ struct Polygon
 {
   std::vector<uint32_t> vertices = {};
   Color color = {};
+  // NOTE: color Packed Into The Native Pixel Format Of The Frame Buffer.
+  Uint32 mapped_color = {};
+  // NOTE: Index Of The Source Polygon In Its Model.
+  uint32_t id = (uint32_t)-1;
 
   NODISCARD  static Vertex Center(const std::vector<Vertex>& vertices, const Polygon& polygon) NOEXCEPT;
 
@@ -53,18 +58,40 @@ struct Model
     uint32_t vertex   = (uint32_t)-1;
   };
 
+  // COMMENT: Undirected Edge Shared By Polygons p0 And p1. p1 Is -1 On A Boundary.
+  struct Edge
+  {
+    uint32_t v0 = (uint32_t)-1;
+    uint32_t v1 = (uint32_t)-1;
+    uint32_t p0 = (uint32_t)-1;
+    uint32_t p1 = (uint32_t)-1;
+  };
+
   std::string name = {};
   
   std::vector<Vertex> vertices  = {};
   std::vector<Index> indices    = {};
 
   std::vector<uint32_t> polygon_sides = {};
+
+  // NOTE: Each Mesh Edge Once, Built By BuildEdges.
+  std::vector<Edge> edges = {};
+
+  // NOTE: Object Space Bounds Of vertices, Set By The Loader.
+  AABB aabb = {};
+
+  // NOTE: Object Space BVH Over The Polygons, Built By BuildBVH. Items Are Polygon Indices.
+  BVH bvh = {};
   
   glm::vec3 scale     = {};
   glm::vec3 rotate    = {};
   glm::vec3 translate = {};
 
   NODISCARD  static Model FromObj(const char* filename) NOEXCEPT;
+
+   static void BuildEdges(Model& model) NOEXCEPT;
+
+   static void BuildBVH(Model& model) NOEXCEPT;
 };
 
 struct ParallelLight
@@ -100,22 +127,77 @@ struct Camera
   float far        = {};
 };
 
+// COMMENT: Screen Tiles For Clear On First Touch. Each Tile Stores The Epoch Of The Frame That Last Touched It.
+CONSTEXPR int TILE_SHIFT = 5;
+CONSTEXPR int TILE_SIZE  = 1 << TILE_SHIFT;
+
+// COMMENT: Coarse Depth Cells Of The ZBuffer. A Tile Holds A Whole Number Of Cells, So Clearing A Tile Clears Its Cells.
+CONSTEXPR int CELL_SHIFT = 3;
+CONSTEXPR int CELL_SIZE  = 1 << CELL_SHIFT;
+
 struct FrameBuffer
 {
   SDL_Window* window                   = {};
   SDL_Surface* surface                 = {};
   const SDL_PixelFormatDetails* format = {};
 
-  int width      = {};
-  int height     = {};
-  Color bgc      = {};
-  Uint32* buffer = {};
+  int width         = {};
+  int height        = {};
+  Color bgc         = {};
+  Uint32 mapped_bgc = {};
+  Uint32* buffer    = {};
+
+  // NOTE: Epoch 0 Marks A Tile That Already Holds The Background Color.
+  int tile_cols         = {};
+  int tile_rows         = {};
+  uint32_t epoch        = {};
+  uint32_t* tile_epochs = {};
+
+  // COMMENT: Room For The Rects Display Presents, One Per Run Of Changed Tiles In A Tile Row. Only A Window's Frame Buffer Has It.
+  SDL_Rect* rects       = {};
 
   NODISCARD  static FrameBuffer From(SDL_Window* window, const Color& bgc) NOEXCEPT;
 
+  // COMMENT: Headless Frame Buffer Over Aligned Memory, For Rendering Without A Display. window And surface Stay nullptr.
+  // NOTE: Rows Are Packed, As They Are In A Window Surface, So The Rasterizers Cannot Tell The Two Apart.
+  NODISCARD  static FrameBuffer From(int width, int height, SDL_PixelFormat format, const Color& bgc) NOEXCEPT;
+
+  // COMMENT: Pixel At (x, y) As The Frame Shows It. Tiles Not Touched This Frame Read As Background, Even Before Display Resets Them.
+  NODISCARD  static Uint32 Pixel(const FrameBuffer& frame_buffer, int x, int y) NOEXCEPT;
+
+  // COMMENT: Reset Tiles Drawn Last Frame But Not This Frame, Then Present The Window, If Any. Only Tiles Drawn In Either Frame Can Differ From What It Shows, So Only They Are Updated.
    static void Display(const FrameBuffer& frame_buffer) NOEXCEPT;
 
-   static void Clear(const FrameBuffer& frame_buffer) NOEXCEPT;
+   static void Clear(FrameBuffer& frame_buffer) NOEXCEPT;
+
+  // COMMENT: Draw The Tiles source Drew This Frame Into frame_buffer, As Rendering Would. Both Must Have The Same Size And Format, And source Must Be Displayed First.
+  // NOTE: Tiles source Left As Background Are Not Read, So Only What Changed Is Copied Once Display Resets The Rest.
+   static void Copy(const FrameBuffer& frame_buffer, const FrameBuffer& source) NOEXCEPT;
+
+  // COMMENT: Stretch All Of source Over All Of frame_buffer, Which Then Counts As Drawn Everywhere. Both Must Have The Same Format, And source Must Be Displayed First.
+  // NOTE: Nearest Picks The Source Pixel Under Each Pixel Center. Bilinear Blends The Four Around It, In 8 Bit Fixed Point.
+   static void Upscale(const FrameBuffer& frame_buffer, const FrameBuffer& source, bool bilinear) NOEXCEPT;
+
+  // COMMENT: Free What From Allocated. A Window's Pixels Belong To Its Surface And Are Left Alone.
+   static void Destroy(FrameBuffer& frame_buffer) NOEXCEPT;
+
+   static void FillTile(const FrameBuffer& frame_buffer, int tx, int ty) NOEXCEPT;
+
+  // COMMENT: Initialize A Tile On Its First Write In This Frame.
+  FORCE_INLINE static void Touch(const FrameBuffer& frame_buffer, const int tx, const int ty) NOEXCEPT
+  {
+    uint32_t& tile_epoch = frame_buffer.tile_epochs[ty * frame_buffer.tile_cols + tx];
+    if (tile_epoch != frame_buffer.epoch)
+    {
+      if (tile_epoch != 0)
+      {
+        FillTile(frame_buffer, tx, ty);
+      }
+      tile_epoch = frame_buffer.epoch;
+    }
+  }
+
+   static void Touch(const FrameBuffer& frame_buffer, int xmin, int xmax, int ymin, int ymax) NOEXCEPT;
 };
 
 struct ZBuffer
@@ -125,73 +207,47 @@ struct ZBuffer
   float bgz      = {};
   float** buffer = {};
 
+  int tile_cols         = {};
+  int tile_rows         = {};
+  uint32_t epoch        = {};
+  uint32_t* tile_epochs = {};
+
+  // COMMENT: Nearest And Farthest Depth Of Each Cell. row_zmax Holds The Farthest Depth Of Each Pixel Row Inside A Cell, CELL_SIZE Rows Per Cell Back To Back.
+  // COMMENT: Bit i Of row_hit Is Set Once Pixel i Of A Cell Row Has Been Depth Tested, Since Until Then The Row Still Holds bgz.
+  // COMMENT: Bit r Of stale Marks Row r Of A Cell Whose row_zmax Is Out Of Date.
+  // NOTE: zmin Is Only Ever Lowered On Writes And zmax Only Lags Behind, So Both Stay Conservative.
+  int cell_cols    = {};
+  int cell_rows    = {};
+  float* zmin      = {};
+  float* zmax      = {};
+  float* row_zmax  = {};
+  uint8_t* row_hit = {};
+  uint8_t* stale   = {};
+
   NODISCARD  static ZBuffer From(const FrameBuffer& frame_buffer, float bgz) NOEXCEPT;
 
-   static void Clear(const ZBuffer& z_buffer) NOEXCEPT;
-};
+   static void Clear(ZBuffer& z_buffer) NOEXCEPT;
 
-struct Canvas;
+   static void Destroy(ZBuffer& z_buffer) NOEXCEPT;
 
-struct ZBH
-{
-    bool valid = false;
-    float zmax = -INF;
-    int xmin   = -1;
-    int xmax   = -1;
-    int ymin   = -1;
-    int ymax   = -1;
-
-    NODISCARD FORCE_INLINE static int Log2(const int x) NOEXCEPT
-    {
-        return ((int)sizeof(uint32_t) << 3) - std::countl_zero((uint32_t)x - 1);
-    }
+   static void FillTile(const ZBuffer& z_buffer, int tx, int ty) NOEXCEPT;
 
-    NODISCARD FORCE_INLINE static int Pow4(const int x) NOEXCEPT
-    {
-        return (1 << (x << 1));
-    }
-    
-    NODISCARD FORCE_INLINE static int Father(const int cur) NOEXCEPT
-    {
-        ASSERT(cur != 0);
-        return (cur - 1) >> 2;
-    }
-    
-    NODISCARD FORCE_INLINE static int Child0(const int cur) NOEXCEPT
-    {
-        return (cur << 2) | 1;
-    }
-    
-    NODISCARD FORCE_INLINE static int Child1(const int cur) NOEXCEPT
-    {
-        return (cur << 2) | 2;
-    }
-    
-    NODISCARD FORCE_INLINE static int Child2(const int cur) NOEXCEPT
-    {
-        return (cur << 2) | 3;
-    }
-    
-    NODISCARD FORCE_INLINE static int Child3(const int cur) NOEXCEPT
+  // COMMENT: Initialize A Tile On Its First Depth Test In This Frame.
+  FORCE_INLINE static void Touch(const ZBuffer& z_buffer, const int tx, const int ty) NOEXCEPT
+  {
+    uint32_t& tile_epoch = z_buffer.tile_epochs[ty * z_buffer.tile_cols + tx];
+    if (tile_epoch != z_buffer.epoch)
     {
-        return (cur << 2) + 4;
+      FillTile(z_buffer, tx, ty);
+      tile_epoch = z_buffer.epoch;
     }
+  }
 
-    NODISCARD FORCE_INLINE static int Child(const int cur, const int i) NOEXCEPT
-    {
-        return (cur << 2) + 1 + i;
-    }
-    
-    NODISCARD static std::vector<ZBH> From(const Canvas& canvas) NOEXCEPT;
-    
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    static void Clear(std::vector<ZBH>& zbh_tree, Canvas& canvas) NOEXCEPT;
-    
-    NODISCARD static float Query(const std::vector<ZBH>& zbh_tree, int xmin, int xmax, int ymin, int ymax) NOEXCEPT;
-    
-    static void Update(std::vector<ZBH>& zbh_tree, Canvas& canvas, int xmin, int xmax, int ymin, int ymax) NOEXCEPT;
+   static void Touch(const ZBuffer& z_buffer, int xmin, int xmax, int ymin, int ymax) NOEXCEPT;
 };
 
+struct HZBuffer;
+
 struct Canvas
 {
   int offsetx               = {};
@@ -200,8 +256,7 @@ struct Canvas
   int height                = {};
   FrameBuffer* frame_buffer = {};
   ZBuffer* z_buffer         = {};
-  // HZBuffer* h_z_buffer      = {};
-  std::vector<ZBH> zbh_tree = {}; 
+  HZBuffer* h_z_buffer      = {};
     
   NODISCARD  static Canvas From(FrameBuffer& frame_buffer, ZBuffer& z_buffer, int offsetx, int offsety, int width, int height) NOEXCEPT;
 };
@@ -214,20 +269,57 @@ struct Setting
     ScanConvertHZBuffer,
     ScanConvertHAABBHZBuffer,
     IntervalScanLine,
+    // COMMENT: Whole Models Are Tested Against The Z Pyramid Through A Scene BVH, Then Drawn With The Plain ZBuffer.
+    ScanConvertBVHHZBuffer,
   };
   enum DisplayMode
   {
     NORMAL,
     WIREFRAME,
   };
+  // COMMENT: When The Z Pyramid Is Rebuilt Above Written Pixels: After Every Polygon, After Every batch_size Polygons,
+  // COMMENT: When A Query Reads A Dirty Texel, Or After Every Model.
+  enum UpdatePolicy
+  {
+    IMMEDIATE,
+    BATCHED,
+    ON_DEMAND,
+    DEFERRED,
+  };
+  enum UpscaleFilter
+  {
+    NEAREST,
+    BILINEAR,
+  };
   
-  bool show_aabb           = {};
-  bool show_normal         = {};
-  bool show_z_buffer       = {};
-  bool enable_cull         = {};
-  bool enable_clip         = {};
-  Algorithm algorithm      = {};
-  DisplayMode display_mode = {};
+  bool show_aabb               = {};
+  bool show_normal             = {};
+  bool show_z_buffer           = {};
+  // NOTE: Replace The Frame With A Heatmap Of How Often Each Pixel Was Written. Only The ZBuffer Algorithms Count Writes.
+  bool show_overdraw           = {};
+  // NOTE: Count The Pixels Left Covered, For The Overdraw Ratio. Takes A Pass Over The Drawn ZBuffer Tiles, So It Is Off Unless Shown.
+  bool count_overdraw          = {};
+  bool enable_cull             = {};
+  bool enable_clip             = {};
+  bool enable_parallel         = {};
+  // NOTE: Rebuild The HAABB In Screen Space Every Frame Instead Of Walking The Model's BVH, For Geometry That Deforms.
+  bool screen_haabb            = {};
+  // NOTE: Draw Models And Their Polygons Nearest First, So Later Ones Fail The Depth Test More Often.
+  bool enable_sort             = {};
+  // NOTE: Draw What Was Visible Last Frame First, Then Test Everything Else Against The Z Pyramid It Leaves.
+  bool temporal_culling        = {};
+  // NOTE: Rasterize The Largest Models Into A Small Occlusion Buffer First, And Skip Every Model Hidden Behind Them.
+  bool occlusion_prepass       = {};
+  Algorithm algorithm          = {};
+  DisplayMode display_mode     = {};
+  UpdatePolicy update_policy   = {};
+  int batch_size               = {};
+  // NOTE: The Window Is Rendered At render_scale Of Its Size, Then Upscaled With upscale_filter. With dynamic_resolution The Scale Follows Render Time Instead, Kept Near frame_budget Milliseconds.
+  // NOTE: Headless Rendering Is Always At Full Size.
+  float render_scale           = {};
+  bool dynamic_resolution      = {};
+  float frame_budget           = {};
+  UpscaleFilter upscale_filter = {};
 };
 
 #endif //ENTITY_H
@@ -192,11 +192,19 @@
     vertex -= center;
     vertex *= scale;
   }
+  model.aabb.vmin = (aabb.vmin - center) * scale;
+  model.aabb.vmax = (aabb.vmax - center) * scale;
 
   // COMMENT: Free Extra Memories.
   model.vertices.shrink_to_fit();
   model.indices.shrink_to_fit();
   model.polygon_sides.shrink_to_fit();
 
+  // COMMENT: Shared Edges For The Wireframe, Built Once With The Mesh.
+  Model::BuildEdges(model);
+
+  // COMMENT: The Polygon BVH Lives In Object Space, So It Survives Any Model Transform And Is Built Once Too.
+  Model::BuildBVH(model);
+
   return SUCCESS;
 }
@@ -0,0 +1,139 @@
+/**
+  ******************************************************************************
+  * @file           : Parallel.cpp
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-11-20
+  ******************************************************************************
+  */
+
+
+
+#include <Parallel.h>
+
+static void Drain(ThreadPool& pool, const int thread) NOEXCEPT
+{
+  for (int index = pool.next.fetch_add(1, std::memory_order_relaxed); index < pool.count; index = pool.next.fetch_add(1, std::memory_order_relaxed))
+  {
+    (*pool.task)(index, thread);
+  }
+}
+
+static void Work(ThreadPool& pool, const int thread, uint64_t seen) NOEXCEPT
+{
+  while (true)
+  {
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.wake.wait(lock, [&]() NOEXCEPT { return pool.stop || pool.generation != seen; });
+    if (pool.stop)
+    {
+      return;
+    }
+    seen = pool.generation;
+    lock.unlock();
+
+    Drain(pool, thread);
+
+    lock.lock();
+    if (--pool.busy == 0)
+    {
+      pool.done.notify_one();
+    }
+  }
+}
+
+// COMMENT: Start threads - 1 Workers, Or One Less Than The Hardware Threads When threads Is Not Positive.
+static void Start(ThreadPool& pool, int threads) NOEXCEPT
+{
+  if (threads <= 0)
+  {
+    threads = std::max((int)std::thread::hardware_concurrency(), 1);
+  }
+  pool.stop = false;
+  pool.workers.reserve(threads - 1);
+  // NOTE: A Pool Restarted By Resize Has Run Tasks Before, So Workers Start From The Current Generation. No Worker Runs Here To Change It.
+  for (int thread = 1; thread < threads; ++thread)
+  {
+    pool.workers.emplace_back(Work, std::ref(pool), thread, pool.generation);
+  }
+}
+
+NODISCARD ThreadPool& ThreadPool::Get() NOEXCEPT
+{
+  static ThreadPool pool;
+  static const bool started = [&]() NOEXCEPT
+  {
+    Start(pool, 0);
+    return true;
+  }();
+  (void)started;
+  return pool;
+}
+
+static void Stop(ThreadPool& pool) NOEXCEPT
+{
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.stop = true;
+  }
+  pool.wake.notify_all();
+  for (auto& worker : pool.workers)
+  {
+    worker.join();
+  }
+  pool.workers.clear();
+}
+
+ThreadPool::~ThreadPool() NOEXCEPT
+{
+  Stop(*this);
+}
+
+void ThreadPool::ShutDown() NOEXCEPT
+{
+  Stop(Get());
+}
+
+void ThreadPool::Resize(const int threads) NOEXCEPT
+{
+  ThreadPool& pool = Get();
+  Stop(pool);
+  Start(pool, threads);
+}
+
+NODISCARD int ThreadPool::Concurrency() NOEXCEPT
+{
+  return (int)Get().workers.size() + 1;
+}
+
+void ThreadPool::ParallelFor(const int count, const Task& task) NOEXCEPT
+{
+  ThreadPool& pool = Get();
+
+  if (pool.workers.empty() || count <= 1)
+  {
+    for (int index = 0; index < count; ++index)
+    {
+      task(index, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    ASSERT(pool.task == nullptr);
+    pool.task  = &task;
+    pool.count = count;
+    pool.next.store(0, std::memory_order_relaxed);
+    pool.busy  = (int)pool.workers.size();
+    ++pool.generation;
+  }
+  pool.wake.notify_all();
+
+  Drain(pool, 0);
+
+  std::unique_lock<std::mutex> lock(pool.mutex);
+  pool.done.wait(lock, [&]() NOEXCEPT { return pool.busy == 0; });
+  pool.task = nullptr;
+}
@@ -0,0 +1,102 @@
+/**
+  ******************************************************************************
+  * @file           : Parallel.h
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-11-20
+  ******************************************************************************
+  */
+
+
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <Common.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// COMMENT: Fixed Pool Of Worker Threads. The Calling Thread Joins In, So Concurrency() Counts It Too.
+struct ThreadPool
+{
+  // COMMENT: Runs task(index, thread) For Every index In [0, count) And Returns When All Are Done. thread Is In [0, Concurrency()).
+  using Task = std::function<void(int index, int thread)>;
+
+  std::vector<std::thread> workers;
+  std::mutex               mutex;
+  std::condition_variable  wake;
+  std::condition_variable  done;
+  const Task*              task       = {};
+  int                      count      = {};
+  std::atomic<int>         next       = {};
+  int                      busy       = {};
+  uint64_t                 generation = {};
+  bool                     stop       = {};
+
+  // NOTE: Joins The Workers If ShutDown Was Never Called, Since Waiting Threads Must Not Outlive The Condition Variables.
+  ~ThreadPool() NOEXCEPT;
+
+  // COMMENT: The Process Wide Pool, Started On First Use With One Thread Per Hardware Thread.
+  NODISCARD static ThreadPool& Get() NOEXCEPT;
+
+  static void ShutDown() NOEXCEPT;
+
+  // COMMENT: Restart The Pool With threads Threads, The Caller Included. 0 Means One Per Hardware Thread.
+  // NOTE: Not While ParallelFor Runs.
+  static void Resize(int threads) NOEXCEPT;
+
+  NODISCARD static int Concurrency() NOEXCEPT;
+
+  // NOTE: Not Reentrant. A Task Must Not Call ParallelFor.
+  static void ParallelFor(int count, const Task& task) NOEXCEPT;
+};
+
+// COMMENT: Lock Free Handoff Of The Latest Value From One Writer Thread To One Reader Thread.
+// COMMENT: The Writer Fills slots[back] And The Reader Uses slots[front]. Publish And Acquire Swap Their Slot With The One In middle, So Neither Ever Waits.
+// NOTE: Slots Are Swapped, Never Copied, So Each Keeps Its Storage From One Use To The Next. A Value Published Before The Reader Took The Last One Is Dropped.
+template<typename T>
+struct TripleBuffer
+{
+  // COMMENT: middle Holds A Slot Index, With FRESH Set When The Writer Put It There After The Reader Last Took One.
+  static CONSTEXPR uint8_t FRESH = 4;
+
+  T slots[3]                  = {};
+  std::atomic<uint8_t> middle = 1;
+  uint8_t back                = 0;
+  uint8_t front               = 2;
+
+  // NOTE: Writer Only.
+  NODISCARD static T& Back(TripleBuffer& buffer) NOEXCEPT
+  {
+    return buffer.slots[buffer.back];
+  }
+
+  // NOTE: Writer Only. Everything Written To Back Before Happens Before The Reader's Acquire Of It.
+  static void Publish(TripleBuffer& buffer) NOEXCEPT
+  {
+    buffer.back = (uint8_t)(buffer.middle.exchange(buffer.back | FRESH, std::memory_order_acq_rel) & (FRESH - 1));
+  }
+
+  // NOTE: Reader Only. Returns false, Keeping Front, When Nothing Was Published Since The Last Acquire.
+  NODISCARD static bool Acquire(TripleBuffer& buffer) NOEXCEPT
+  {
+    if ((buffer.middle.load(std::memory_order_relaxed) & FRESH) == 0)
+    {
+      return false;
+    }
+    buffer.front = (uint8_t)(buffer.middle.exchange(buffer.front, std::memory_order_acq_rel) & (FRESH - 1));
+    return true;
+  }
+
+  // NOTE: Reader Only.
+  NODISCARD static T& Front(TripleBuffer& buffer) NOEXCEPT
+  {
+    return buffer.slots[buffer.front];
+  }
+};
+
+#endif //PARALLEL_H
@@ -13,6 +13,376 @@
 #include <Pipeline.h>
 #include <Rasterizer.h>
 #include <Transformer.h>
+#include <Acceleration/HZBuffer.h>
+#include <Acceleration/BVH.h>
+#include <Acceleration/OcclusionBuffer.h>
+#include <Profiler.h>
+
+Pipeline::Statistic Pipeline::statistic = {};
+std::unordered_map<const Model*, uint64_t> Pipeline::visible_pixels = {};
+
+// COMMENT: Models Whose Canvas Rect Covers At Least This Share Of The Canvas Are Occluder Candidates. The Largest Are Taken Until Their Vertices Would Exceed The Budget.
+CONSTEXPR float  OCCLUDER_COVERAGE = 1.0f / 64.0f;
+CONSTEXPR size_t OCCLUDER_VERTICES = 1 << 15;
+
+// COMMENT: A Cached Draw Order Is Reused While No Entry Of The View Matrix Has Moved Further Than This, About 3 Degrees Of Rotation.
+CONSTEXPR float SORT_TOLERANCE = 0.05f;
+
+// COMMENT: Append A Model's Polygons To The Scene Batch, Rebasing Their Vertex Indices.
+static void Merge(std::vector<Vertex>& scene_vertices, std::vector<Polygon>& scene_polygons, const std::vector<Vertex>& vertices, std::vector<Polygon>& polygons) NOEXCEPT
+{
+  const uint32_t base = (uint32_t)scene_vertices.size();
+  scene_vertices.insert(scene_vertices.end(), vertices.begin(), vertices.end());
+  for (auto& polygon : polygons)
+  {
+    for (auto& vertex : polygon.vertices)
+    {
+      vertex += base;
+    }
+    scene_polygons.emplace_back(std::move(polygon));
+  }
+}
+
+// COMMENT: Polygon Order Of A Model And The View It Was Sorted Under.
+struct Order
+{
+  glm::mat4 MV = {};
+  std::vector<uint32_t> ids = {};
+};
+
+// COMMENT: Front To Back Order Of Each Model. Keys Are Only Looked Up, Never Dereferenced.
+static std::unordered_map<const Model*, Order> orders;
+
+// COMMENT: Visibility From The Last Frame Per Node Of Each Model's Own BVH, For Temporal Culling Of Its Leaves.
+static std::unordered_map<const Model*, std::vector<uint8_t>> visible_leaves;
+
+// COMMENT: Drop The State Kept For Models No Longer In The Scene, So A Model Later Allocated At The Same Address Starts Afresh.
+static void Prune(const std::vector<const Model*>& models) NOEXCEPT
+{
+  static std::vector<const Model*> sorted;
+  sorted.assign(models.begin(), models.end());
+  std::sort(sorted.begin(), sorted.end());
+  const auto gone = [&](const auto& entry) NOEXCEPT -> bool {
+    return !std::binary_search(sorted.begin(), sorted.end(), entry.first);
+  };
+  std::erase_if(orders, gone);
+  std::erase_if(visible_leaves, gone);
+}
+
+// COMMENT: Map A Float To A Key Whose Unsigned Order Matches The Float Order. Negatives Flip Every Bit, Positives Only The Sign Bit.
+NODISCARD static uint32_t SortKey(const float f) NOEXCEPT
+{
+  const uint32_t u = std::bit_cast<uint32_t>(f);
+  return u ^ ((uint32_t)((int32_t)u >> 31) | 0x80000000u);
+}
+
+// COMMENT: Reorder polygons Nearest First By The Nearest Canvas Depth Of Their Vertices. Least Significant Digit First Radix Sort, 8 Bits Per Pass.
+// COMMENT: The Order Is Kept Per Model With The View It Was Sorted Under, And Replayed Until The View Moves Past SORT_TOLERANCE.
+// NOTE: A Stale Order Only Costs Overdraw, Never Pixels, So Polygons Missing From It Are Simply Drawn Last.
+static void SortFrontToBack(const Model& model, const glm::mat4& MV, const std::vector<Vertex>& vertices, std::vector<Polygon>& polygons) NOEXCEPT
+{
+  static std::vector<uint32_t> keys;     keys.clear();
+  static std::vector<uint32_t> slots;    slots.clear();
+  static std::vector<uint32_t> keys_tmp;
+  static std::vector<uint32_t> slots_tmp;
+  static std::vector<uint32_t> index;
+  static std::vector<Polygon>  sorted;   sorted.clear();
+
+  Order& order = orders[&model];
+  bool reuse = !order.ids.empty();
+  for (int i = 0; i < 4 && reuse; ++i)
+  {
+    for (int j = 0; j < 4 && reuse; ++j)
+    {
+      reuse = std::abs(MV[i][j] - order.MV[i][j]) <= SORT_TOLERANCE;
+    }
+  }
+
+  if (!reuse)
+  {
+    keys.reserve(polygons.size());
+    slots.reserve(polygons.size());
+    for (size_t i = 0; i < polygons.size(); ++i)
+    {
+      float z = INF;
+      for (const auto& vertex : polygons[i].vertices)
+      {
+        z = std::min(z, vertices[vertex].z);
+      }
+      keys.emplace_back(SortKey(z));
+      slots.emplace_back((uint32_t)i);
+    }
+    keys_tmp.resize(keys.size());
+    slots_tmp.resize(slots.size());
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+      uint32_t count[257] = {};
+      for (const auto key : keys)
+      {
+        ++count[((key >> shift) & 0xFFu) + 1];
+      }
+      // NOTE: Depths Of One Model Often Share Their High Bytes, Which Makes Those Passes A Plain Copy.
+      if (std::find(count + 1, count + 257, (uint32_t)keys.size()) != count + 257)
+      {
+        continue;
+      }
+      for (int digit = 0; digit < 256; ++digit)
+      {
+        count[digit + 1] += count[digit];
+      }
+      for (size_t i = 0; i < keys.size(); ++i)
+      {
+        const uint32_t slot = count[(keys[i] >> shift) & 0xFFu]++;
+        keys_tmp[slot] = keys[i];
+        slots_tmp[slot] = slots[i];
+      }
+      keys.swap(keys_tmp);
+      slots.swap(slots_tmp);
+    }
+
+    order.MV = MV;
+    order.ids.clear();
+    sorted.reserve(polygons.size());
+    for (const auto slot : slots)
+    {
+      order.ids.emplace_back(polygons[slot].id);
+      sorted.emplace_back(std::move(polygons[slot]));
+    }
+    polygons.swap(sorted);
+    return;
+  }
+
+  index.assign(model.polygon_sides.size(), (uint32_t)-1);
+  for (size_t i = 0; i < polygons.size(); ++i)
+  {
+    index[polygons[i].id] = (uint32_t)i;
+  }
+  sorted.reserve(polygons.size());
+  for (const auto id : order.ids)
+  {
+    if (id < index.size() && index[id] != (uint32_t)-1)
+    {
+      sorted.emplace_back(std::move(polygons[index[id]]));
+      index[id] = (uint32_t)-1;
+    }
+  }
+  for (auto& polygon : polygons)
+  {
+    if (index[polygon.id] != (uint32_t)-1)
+    {
+      sorted.emplace_back(std::move(polygon));
+    }
+  }
+  polygons.swap(sorted);
+}
+
+// COMMENT: Number Of ZBuffer Pixels Nearer Than bgz. Tiles Not Touched This Frame Still Hold Last Frame's Depths And Are Skipped.
+NODISCARD static uint64_t CountCovered(const ZBuffer& z_buffer) NOEXCEPT
+{
+  uint64_t covered = 0;
+  for (int ty = 0; ty < z_buffer.tile_rows; ++ty)
+  {
+    for (int tx = 0; tx < z_buffer.tile_cols; ++tx)
+    {
+      if (z_buffer.tile_epochs[ty * z_buffer.tile_cols + tx] != z_buffer.epoch)
+      {
+        continue;
+      }
+      const int xmax = std::min((tx + 1) << TILE_SHIFT, z_buffer.width);
+      const int ymax = std::min((ty + 1) << TILE_SHIFT, z_buffer.height);
+      for (int y = ty << TILE_SHIFT; y < ymax; ++y)
+      {
+        const float* row = z_buffer.buffer[y];
+        for (int x = tx << TILE_SHIFT; x < xmax; ++x)
+        {
+          covered += row[x] != z_buffer.bgz;
+        }
+      }
+    }
+  }
+  return covered;
+}
+
+// COMMENT: Outline The Canvas Rect [rect.x, rect.y] x [rect.z, rect.w].
+static void RenderRect(const Canvas& canvas, const glm::ivec4& rect) NOEXCEPT
+{
+  Rasterizer::RenderTangentBresenham(canvas, rect.x, rect.z, rect.y, rect.z, Color(1.0f, 0.0f, 0.0f));
+  Rasterizer::RenderTangentBresenham(canvas, rect.x, rect.w, rect.y, rect.w, Color(1.0f, 0.0f, 0.0f));
+  Rasterizer::RenderTangentBresenham(canvas, rect.x, rect.z, rect.x, rect.w, Color(1.0f, 0.0f, 0.0f));
+  Rasterizer::RenderTangentBresenham(canvas, rect.y, rect.z, rect.y, rect.w, Color(1.0f, 0.0f, 0.0f));
+}
+
+// COMMENT: Occlusion Prepass. The Chosen Occluders Are Rasterized Into The Occlusion Buffer, Then Every Other Model's Box Is Tested Against It And hidden Marks Those Behind.
+// NOTE: Occluders Are Always Drawn, And Only Their Polygons That The Pipeline Draws Whole Are Used, So No Bound In The Buffer Is Nearer Than The Final Depth.
+static void Prepass(const Setting& setting, const Canvas& canvas, const glm::mat4& V, const glm::mat4& P, const std::vector<const Model*>& models, const std::vector<AABB>& aabbs, std::vector<uint8_t>& hidden) NOEXCEPT
+{
+  static OcclusionBuffer         occlusion_buffer;
+  static std::vector<glm::ivec4> rects;      rects.resize(models.size());
+  static std::vector<float>      znears;     znears.resize(models.size());
+  static std::vector<uint8_t>    projected;  projected.assign(models.size(), 0);
+  static std::vector<uint8_t>    occluder;   occluder.assign(models.size(), 0);
+  static std::vector<uint32_t>   candidates; candidates.clear();
+  static std::vector<Vertex>     view;
+  static std::vector<Vertex>     screen;
+  static Polygon                 polygon;
+
+  OcclusionBuffer::Clear(occlusion_buffer, canvas);
+
+  const auto area = [&](const uint32_t i) NOEXCEPT -> float {
+    return (float)(rects[i].y - rects[i].x + 1) * (float)(rects[i].w - rects[i].z + 1);
+  };
+
+  const glm::mat4 PV = P * V;
+  for (uint32_t i = 0; i < (uint32_t)models.size(); ++i)
+  {
+    projected[i] = Transformer::ProjectAABB(canvas, PV, aabbs[i], setting.enable_clip, rects[i], znears[i]);
+    if (projected[i] && area(i) >= OCCLUDER_COVERAGE * (float)canvas.width * (float)canvas.height)
+    {
+      candidates.emplace_back(i);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [&](const uint32_t a, const uint32_t b) NOEXCEPT -> bool {
+    return area(a) > area(b);
+  });
+
+  const glm::mat4 viewport = Transformer::Viewport(canvas);
+  size_t budget = OCCLUDER_VERTICES;
+  for (const auto i : candidates)
+  {
+    const Model& model = *models[i];
+    if (model.vertices.size() > budget)
+    {
+      continue;
+    }
+    budget -= model.vertices.size();
+    occluder[i] = 1;
+    ++Pipeline::statistic.occluder_models;
+
+    // COMMENT: The Same Transforms As The Pipeline, In The Same Order, So Back Faces And Canvas Positions Come Out Bit For Bit The Same.
+    // NOTE: A Vertex Behind The Eye Or Outside The Clip Volume Is Sent To INF, Which Keeps Its Polygons Out.
+    const glm::mat4 MV = V * Transformer::Model(model);
+    view.clear();
+    screen.clear();
+    for (const auto& vertex : model.vertices)
+    {
+      glm::vec4 t = MV * glm::vec4(vertex, 1.0f);
+      view.emplace_back(t.xyz() / t.w);
+      t = P * glm::vec4(view.back(), 1.0f);
+      const Vertex ndc = t.xyz() / t.w;
+      if (t.w <= 0.0f || std::abs(ndc.x) > 1.0f || std::abs(ndc.y) > 1.0f || std::abs(ndc.z) > 1.0f)
+      {
+        screen.emplace_back(INF);
+        continue;
+      }
+      t = viewport * glm::vec4(ndc, 1.0f);
+      screen.emplace_back(t.xyz() / t.w);
+    }
+
+    for (size_t p = 0, j = 0; p < model.polygon_sides.size() && j < model.indices.size(); j += model.polygon_sides[p], ++p)
+    {
+      polygon.vertices.clear();
+      for (uint32_t k = 0; k < model.polygon_sides[p]; ++k)
+      {
+        polygon.vertices.emplace_back(model.indices[j + k].vertex);
+      }
+      if (setting.enable_cull && glm::dot(Polygon::Center(view, polygon), Polygon::Normal(view, polygon)) >= 0.0f)
+      {
+        continue;
+      }
+
+      Vertex points[OCCLUSION_MAX_SIDES];
+      int count = 0;
+      for (const auto vertex : polygon.vertices)
+      {
+        if (count == OCCLUSION_MAX_SIDES || screen[vertex].x == INF)
+        {
+          count = 0;
+          break;
+        }
+        points[count++] = screen[vertex];
+      }
+      if (OcclusionBuffer::Render(occlusion_buffer, points, count))
+      {
+        ++Pipeline::statistic.occluder_polygons;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < (uint32_t)models.size(); ++i)
+  {
+    if (projected[i] && !occluder[i])
+    {
+      ++Pipeline::statistic.prepass_tested;
+      if (OcclusionBuffer::Query(occlusion_buffer, rects[i], znears[i]))
+      {
+        hidden[i] = 1;
+        ++Pipeline::statistic.prepass_culled;
+      }
+    }
+  }
+}
+
+// COMMENT: Pop Scene BVH Nodes Until A Leaf Passes The Tests And Return Its Item, Or -1 When None Is Left. rect Is Then The Leaf's Canvas Rect.
+// COMMENT: The Nearer Child Is Pushed Last, So Models Come Out Front To Back And Later Nodes Are Tested Against Everything Drawn Before.
+static int Next(const BVH& bvh, std::vector<uint32_t>& stack, Canvas& canvas, const glm::mat4& PV, const Vertex& eye, const bool clip, glm::ivec4& rect) NOEXCEPT
+{
+  while (!stack.empty())
+  {
+    const uint32_t id = stack.back();
+    const BVH::Node& node = bvh.nodes[id];
+    stack.pop_back();
+
+    ++Pipeline::statistic.tested_nodes;
+    float znear;
+    if (!Transformer::ProjectAABB(canvas, PV, AABB{ node.vmin, node.vmax }, clip, rect, znear) || HZBuffer::Query(*canvas.h_z_buffer, rect.x, rect.y, rect.z, rect.w) <= znear)
+    {
+      ++Pipeline::statistic.culled_nodes;
+      continue;
+    }
+
+    if (node.count != 0)
+    {
+      return (int)bvh.items[node.index];
+    }
+
+    const BVH::Node& l = bvh.nodes[id + 1];
+    const BVH::Node& r = bvh.nodes[node.index];
+    const Vector dl = (l.vmin + l.vmax) / 2.0f - eye;
+    const Vector dr = (r.vmin + r.vmax) / 2.0f - eye;
+    if (glm::dot(dl, dl) <= glm::dot(dr, dr))
+    {
+      stack.emplace_back(node.index);
+      stack.emplace_back(id + 1);
+    }
+    else
+    {
+      stack.emplace_back(id + 1);
+      stack.emplace_back(node.index);
+    }
+  }
+  return -1;
+}
+
+ void Pipeline::Clear(const Setting& setting, Canvas& canvas) NOEXCEPT
+{
+  switch (setting.algorithm)
+  {
+    case Setting::ScanConvertZBuffer:
+      ZBuffer::Clear(*canvas.z_buffer);
+    break;
+    case Setting::ScanConvertHZBuffer: 
+    case Setting::ScanConvertHAABBHZBuffer:
+    case Setting::ScanConvertBVHHZBuffer:
+      ZBuffer::Clear(*canvas.z_buffer);
+      HZBuffer::Clear(*canvas.h_z_buffer);
+    break;
+    case Setting::IntervalScanLine: 
+    break;
+    default:
+      Fatal("Unsupported Algorithm");
+  }
+}
 
  void Pipeline::Render(const Setting& setting, const Shader::Config& config, Canvas& canvas, const Camera& camera, const Scene& scene) NOEXCEPT
 {
@@ -21,15 +391,75 @@
 
   static std::vector<Vertex>        vertices;                vertices.clear();
   static std::vector<Polygon>       polygons;                polygons.clear();
+  static std::vector<Vertex>        centers;                 centers.clear();
+  static std::vector<Normal>        normals;                 normals.clear();
 
   static std::vector<Vertex>        polygon_normal_vertices; polygon_normal_vertices.clear();
   static std::vector<Polygon>       polygon_normals;         polygon_normals.clear();
 
   static std::vector<bool>          visited;                 visited.clear();
+  static std::vector<uint32_t>      index;                   index.clear();
+  static std::vector<glm::ivec4>    rects;                   rects.clear();
+  static std::vector<HAABB>         haabbs;
+
+  // COMMENT: Interval Scan Line Resolves Visibility Between Models, So It Runs Once Over The Whole Scene.
+  static std::vector<Vertex>        scene_vertices;          scene_vertices.clear();
+  static std::vector<Polygon>       scene_polygons;          scene_polygons.clear();
+  static std::vector<Vertex>        scene_normal_vertices;   scene_normal_vertices.clear();
+  static std::vector<Polygon>       scene_normals;           scene_normals.clear();
+
+  // COMMENT: Scene BVH Over The World Space Boxes Of All Models, Rebuilt Every Frame Since Any Model May Have Moved.
+  static std::vector<const Model*>  models;                  models.clear();
+  static std::vector<AABB>          aabbs;                   aabbs.clear();
+  static BVH                        bvh;
+  static std::vector<uint32_t>      stack;                   stack.clear();
+  static std::vector<uint32_t>      sequence;                sequence.clear();
+
+  // COMMENT: Visibility From The Last Frame Per Scene BVH Item. Leaves Are Kept Per Model In visible_leaves.
+  // NOTE: Items Follow The Scene Order, So Adding Or Removing Models Only Costs One Frame Of Culling, Never Pixels.
+  static std::vector<uint8_t>       visible_models;
+  static std::vector<uint32_t>      phase;                   phase.clear();
+  static std::vector<uint8_t>       drawn;                   drawn.clear();
+  static std::vector<uint8_t>       seen;                    seen.clear();
+
+  // COMMENT: Models The Occlusion Prepass Found Hidden, By Item.
+  static std::vector<uint8_t>       hidden;                  hidden.clear();
+
+  // COMMENT: Occlusion Query Counts Of This Frame, Published To visible_pixels Once It Ends.
+  static std::unordered_map<const Model*, uint64_t> pixels;  pixels.clear();
+
+  const bool merge = setting.display_mode == Setting::NORMAL && setting.algorithm == Setting::IntervalScanLine;
+  const bool traverse = setting.algorithm == Setting::ScanConvertBVHHZBuffer;
+  // COMMENT: The Scene BVH Already Visits Models Front To Back, So Only The Other Algorithms Sort Them.
+  const bool sort = setting.enable_sort && setting.display_mode == Setting::NORMAL;
+  const bool temporal = setting.temporal_culling && setting.display_mode == Setting::NORMAL && (traverse || (setting.algorithm == Setting::ScanConvertHAABBHZBuffer && !setting.screen_haabb));
+  const bool sort_models = (sort || temporal) && !traverse && !merge;
+  const bool prepass = setting.occlusion_prepass && setting.display_mode == Setting::NORMAL;
+  // COMMENT: Only The ZBuffer Algorithms Test Depth Per Pixel, So Only They Answer Occlusion Queries.
+  const bool query = setting.display_mode == Setting::NORMAL && setting.algorithm != Setting::IntervalScanLine;
 
   parallel_lights.reserve(scene.parallel_lights.size());
   point_lights.reserve(scene.point_lights.size());
 
+  Rasterizer::statistic = {};
+  HZBuffer::statistic = {};
+  statistic = {};
+
+  // COMMENT: Writes Are Only Counted Per Pixel While The Overdraw View Is On, Since It Keeps RenderSpan Off Its Vector Paths.
+  if (setting.show_overdraw && query)
+  {
+    Rasterizer::overdraw.assign((size_t)canvas.width * (size_t)canvas.height, 0);
+  }
+  else
+  {
+    Rasterizer::overdraw.clear();
+  }
+
+  if (canvas.h_z_buffer != nullptr)
+  {
+    HZBuffer::Configure(*canvas.h_z_buffer, setting.update_policy, setting.batch_size);
+  }
+
   const glm::mat4 V = Transformer::View(camera);
 
   for (const auto& light : scene.parallel_lights)
@@ -46,6 +476,130 @@
 
   for (const auto& model : scene.models)
   {
+    AABB aabb = model.aabb;
+    Transformer::TransformAABB(aabb, Transformer::Model(model));
+    models.emplace_back(&model);
+    aabbs.emplace_back(aabb);
+    if (query)
+    {
+      pixels.emplace(&model, 0);
+    }
+  }
+  Prune(models);
+
+  if (traverse)
+  {
+    {
+      PROFILE_SCOPE(Profiler::HAABB_BUILD);
+      BVH::Build(bvh, aabbs.data(), (uint32_t)aabbs.size(), 1);
+    }
+    if (!bvh.nodes.empty())
+    {
+      stack.emplace_back(0);
+    }
+    if (temporal)
+    {
+      visible_models.resize(models.size(), 0);
+      drawn.assign(models.size(), 0);
+      for (uint32_t item = 0; item < (uint32_t)models.size(); ++item)
+      {
+        if (visible_models[item] != 0)
+        {
+          phase.emplace_back(item);
+        }
+        visible_models[item] = 0;
+      }
+    }
+  }
+  else
+  {
+    sequence.resize(models.size());
+    std::iota(sequence.begin(), sequence.end(), 0u);
+  }
+
+  if (sort_models)
+  {
+    // COMMENT: With Temporal Culling, Models That Had A Visible Leaf Last Frame Go First, So The Z Pyramid Holds Their Depths Before The Rest Are Walked.
+    seen.assign(models.size(), 0);
+    for (size_t i = 0; i < models.size() && temporal; ++i)
+    {
+      const auto leaves = visible_leaves.find(models[i]);
+      seen[i] = leaves != visible_leaves.end() && std::find(leaves->second.begin(), leaves->second.end(), 1) != leaves->second.end();
+    }
+    std::stable_sort(sequence.begin(), sequence.end(), [&](const uint32_t a, const uint32_t b) NOEXCEPT -> bool {
+      if (seen[a] != seen[b])
+      {
+        return seen[a] > seen[b];
+      }
+      if (!sort)
+      {
+        return false;
+      }
+      const Vector da = AABB::Center(aabbs[a]) - camera.position;
+      const Vector db = AABB::Center(aabbs[b]) - camera.position;
+      return glm::dot(da, da) < glm::dot(db, db);
+    });
+  }
+
+  const glm::mat4 PV = Transformer::Project(camera) * V;
+  glm::ivec4 rect = {};
+  size_t cursor = 0;
+
+  hidden.assign(models.size(), 0);
+  if (prepass)
+  {
+    PROFILE_SCOPE(Profiler::CULL);
+    const auto start = std::chrono::high_resolution_clock::now();
+    Prepass(setting, canvas, V, Transformer::Project(camera), models, aabbs, hidden);
+    statistic.prepass_time = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+  }
+
+  for (;;)
+  {
+    int item = -1;
+    if (traverse)
+    {
+      // COMMENT: Phase One Draws The Models Visible Last Frame That Are Still On Screen, Without Asking The Z Pyramid.
+      while (item < 0 && cursor < phase.size())
+      {
+        float znear;
+        if (Transformer::ProjectAABB(canvas, PV, aabbs[phase[cursor]], setting.enable_clip, rect, znear))
+        {
+          item = (int)phase[cursor];
+          drawn[item] = 1;
+        }
+        ++cursor;
+      }
+      // COMMENT: Phase Two Walks The Scene BVH. Every Model It Reaches Is Visible Next Frame, But Those From Phase One Are Not Drawn Again.
+      while (item < 0)
+      {
+        item = Next(bvh, stack, canvas, PV, camera.position, setting.enable_clip, rect);
+        if (item < 0 || !temporal)
+        {
+          break;
+        }
+        visible_models[item] = 1;
+        if (drawn[item] != 0)
+        {
+          item = -1;
+        }
+      }
+    }
+    else if (cursor < sequence.size())
+    {
+      item = (int)sequence[cursor++];
+    }
+    if (item < 0)
+    {
+      break;
+    }
+    if (hidden[item] != 0)
+    {
+      continue;
+    }
+    const Model& model = *models[item];
+    ++statistic.drawn_models;
+
     vertices.clear(); vertices.reserve(model.vertices.size());
     polygons.clear(); polygons.reserve(model.polygon_sides.size());
 
@@ -57,79 +611,110 @@
 
     const glm::mat4 MV = V * Transformer::Model(model);
     
-    for (const auto& vertex : model.vertices)
     {
-      glm::vec4 t = MV * glm::vec4(vertex, 1.0f);
-      vertices.emplace_back(t.xyz() / t.w);
+      PROFILE_SCOPE(Profiler::TRANSFORM);
+      for (const auto& vertex : model.vertices)
+      {
+        glm::vec4 t = MV * glm::vec4(vertex, 1.0f);
+        vertices.emplace_back(t.xyz() / t.w);
+      }
     }
 
-    for (size_t i = 0, j = 0; i < model.polygon_sides.size() && j < model.indices.size(); j += model.polygon_sides[i], ++i)
+    // COMMENT: Assemble And Cull Polygons First, Then Shade The Survivors, So The Two Stages Are Timed Apart. Centers And Normals Carry Over.
     {
-      Polygon polygon;
-      
-      polygon.vertices.reserve(model.polygon_sides[i]);
-      for (uint32_t k = 0; k < model.polygon_sides[i]; ++k)
+      PROFILE_SCOPE(Profiler::CULL);
+      statistic.input_polygons += (uint32_t)model.polygon_sides.size();
+      centers.clear(); centers.reserve(model.polygon_sides.size());
+      normals.clear(); normals.reserve(model.polygon_sides.size());
+      for (size_t i = 0, j = 0; i < model.polygon_sides.size() && j < model.indices.size(); j += model.polygon_sides[i], ++i)
       {
-        polygon.vertices.emplace_back(model.indices[j + k].vertex);
-      }
+        Polygon polygon;
+        polygon.id = (uint32_t)i;
+        
+        polygon.vertices.reserve(model.polygon_sides[i]);
+        for (uint32_t k = 0; k < model.polygon_sides[i]; ++k)
+        {
+          polygon.vertices.emplace_back(model.indices[j + k].vertex);
+        }
 
-      Vertex c = Polygon::Center(vertices, polygon);
-      Normal n = Polygon::Normal(vertices, polygon);
+        Vertex c = Polygon::Center(vertices, polygon);
+        Normal n = Polygon::Normal(vertices, polygon);
 
-      if (setting.enable_cull)
-      {
-        if (glm::dot(c, n) >= 0.0f) { continue; }
+        if (setting.enable_cull)
+        {
+          if (glm::dot(c, n) >= 0.0f) { ++statistic.backface_culled; continue; }
+        }
+
+        centers.emplace_back(c);
+        normals.emplace_back(n);
+        polygons.emplace_back(std::move(polygon));
       }
+    }
 
-      polygon.color = Shader::BlinnPhong(parallel_lights, point_lights, c, n, config);
-      
-      if (setting.show_normal)
+    {
+      PROFILE_SCOPE(Profiler::SHADE);
+      for (size_t i = 0; i < polygons.size(); ++i)
       {
-        polygon_normal_vertices.emplace_back(c);
-        polygon_normal_vertices.emplace_back(c + 0.1f * n);
+        const Vertex& c = centers[i];
+        const Normal& n = normals[i];
 
-        Polygon line;
-        line.vertices = {(uint32_t)(polygon_normal_vertices.size() - 2), (uint32_t)(polygon_normal_vertices.size() - 1)};
-        line.color = Color(0.0f, 1.0f, 0.0f);
+        polygons[i].color = Shader::BlinnPhong(parallel_lights, point_lights, c, n, config);
         
-        polygon_normals.emplace_back(std::move(line));
+        if (setting.show_normal)
+        {
+          polygon_normal_vertices.emplace_back(c);
+          polygon_normal_vertices.emplace_back(c + 0.1f * n);
+
+          Polygon line;
+          line.vertices = {(uint32_t)(polygon_normal_vertices.size() - 2), (uint32_t)(polygon_normal_vertices.size() - 1)};
+          line.color = Color(0.0f, 1.0f, 0.0f);
+          
+          polygon_normals.emplace_back(std::move(line));
+        }
       }
-      
-      polygons.emplace_back(std::move(polygon));
+
+      // COMMENT: Pack Shaded Colors Into The Frame Buffer Format Once, So Rasterizers Only Store Pixels.
+      Rasterizer::MapColors(*canvas.frame_buffer, polygons);
+      Rasterizer::MapColors(*canvas.frame_buffer, polygon_normals);
     }
 
     glm::mat4 P = Transformer::Project(camera);
 
-    visited.clear(); visited.resize(vertices.size(), false);
-    for (auto& polygon : polygons)
     {
-      for (const auto& vertex : polygon.vertices)
+      PROFILE_SCOPE(Profiler::TRANSFORM);
+      visited.clear(); visited.resize(vertices.size(), false);
+      for (auto& polygon : polygons)
       {
-        if (!visited[vertex])
+        for (const auto& vertex : polygon.vertices)
         {
-          visited[vertex] = true;
-          glm::vec4 t = P * glm::vec4(vertices[vertex], 1.0f);
-          vertices[vertex] = t.xyz() / t.w;
+          if (!visited[vertex])
+          {
+            visited[vertex] = true;
+            glm::vec4 t = P * glm::vec4(vertices[vertex], 1.0f);
+            vertices[vertex] = t.xyz() / t.w;
+          }
         }
       }
-    }
 
-    visited.clear(); visited.resize(polygon_normal_vertices.size(), false);
-    for (auto& polygon : polygon_normals)
-    {
-      for (const auto& vertex : polygon.vertices)
+      visited.clear(); visited.resize(polygon_normal_vertices.size(), false);
+      for (auto& polygon : polygon_normals)
       {
-        if (!visited[vertex])
+        for (const auto& vertex : polygon.vertices)
         {
-          visited[vertex] = true;
-          glm::vec4 t = P * glm::vec4(polygon_normal_vertices[vertex], 1.0f);
-          polygon_normal_vertices[vertex] = t.xyz() / t.w;
+          if (!visited[vertex])
+          {
+            visited[vertex] = true;
+            glm::vec4 t = P * glm::vec4(polygon_normal_vertices[vertex], 1.0f);
+            polygon_normal_vertices[vertex] = t.xyz() / t.w;
+          }
         }
       }
     }
     
     if (setting.enable_clip)
     {
+      PROFILE_SCOPE(Profiler::CLIP);
+
       AABB aabb;
       aabb.vmin = Vertex(-1.0f, -1.0f, -1.0f);
       aabb.vmax = Vertex(1.0f, 1.0f, 1.0f);
@@ -145,8 +730,10 @@
           ++i, --j;
         }
 
+        const size_t count = polygons.size();
         if ((size_t)i == polygons.size() || !AABB::OverLap(aabb, AABB::From(vertices, polygons[i]))) { polygons.resize(i); }
         else { polygons.resize(i + 1); }
+        statistic.clipped_polygons += (uint32_t)(count - polygons.size());
       }
       {
         int i = 0, j = polygon_normals.size() - 1;
@@ -164,86 +751,164 @@
       }
     }
 
-    glm::mat4 viewport = Transformer::Viewport(canvas);
-
-    visited.clear(); visited.resize(vertices.size(), false);
-    for (auto& polygon : polygons)
     {
-      for (const auto& vertex : polygon.vertices)
+      PROFILE_SCOPE(Profiler::VIEWPORT);
+      glm::mat4 viewport = Transformer::Viewport(canvas);
+
+      visited.clear(); visited.resize(vertices.size(), false);
+      for (auto& polygon : polygons)
       {
-        if (!visited[vertex])
+        for (const auto& vertex : polygon.vertices)
         {
-          visited[vertex] = true;
-          glm::vec4 t = viewport * glm::vec4(vertices[vertex], 1.0f);
-          vertices[vertex] = t.xyz() / t.w;
+          if (!visited[vertex])
+          {
+            visited[vertex] = true;
+            glm::vec4 t = viewport * glm::vec4(vertices[vertex], 1.0f);
+            vertices[vertex] = t.xyz() / t.w;
+          }
         }
       }
-    }
-    visited.clear(); visited.resize(polygon_normal_vertices.size(), false);
-    for (auto& polygon : polygon_normals)
-    {
-      for (const auto& vertex : polygon.vertices)
+      visited.clear(); visited.resize(polygon_normal_vertices.size(), false);
+      for (auto& polygon : polygon_normals)
       {
-        if (!visited[vertex])
+        for (const auto& vertex : polygon.vertices)
         {
-          visited[vertex] = true;
-          glm::vec4 t = viewport * glm::vec4(polygon_normal_vertices[vertex], 1.0f);
-          polygon_normal_vertices[vertex] = t.xyz() / t.w;
+          if (!visited[vertex])
+          {
+            visited[vertex] = true;
+            glm::vec4 t = viewport * glm::vec4(polygon_normal_vertices[vertex], 1.0f);
+            polygon_normal_vertices[vertex] = t.xyz() / t.w;
+          }
         }
       }
     }
 
-    if (setting.display_mode == Setting::NORMAL)
     {
-      if (setting.algorithm == Setting::ScanConvertZBuffer)
+      PROFILE_SCOPE(Profiler::RASTERIZE);
+      // COMMENT: The Hierarchical AABB Algorithm Orders Its Own Traversal, And The Interval Scan Line Does Not Depend On Order.
+      if (sort && (setting.algorithm == Setting::ScanConvertZBuffer || setting.algorithm == Setting::ScanConvertHZBuffer || setting.algorithm == Setting::ScanConvertBVHHZBuffer))
       {
-        Rasterizer::RenderPolygonsScanConvertZBuffer(canvas, vertices, polygons);
+        SortFrontToBack(model, MV, vertices, polygons);
       }
-      else if (setting.algorithm == Setting::ScanConvertHZBuffer)
-      {
-        Rasterizer::RenderPolygonsScanConvertHZBuffer(canvas, vertices, polygons);
-      }
-      else if (setting.algorithm == Setting::ScanConvertHAABBHZBuffer)
+
+      // COMMENT: A Model's Query Result Is The Growth Of The Rasterizer's Written Pixel Count While It Is Drawn, Which Costs Nothing Extra Per Pixel.
+      const uint64_t written_pixels = Rasterizer::statistic.written_pixels;
+
+      if (setting.display_mode == Setting::NORMAL)
       {
-        auto haabbs = HAABB::Build(vertices, polygons);
-        Rasterizer::RenderPolygonsScanConvertHAABBHZBuffer(canvas, vertices, polygons, haabbs);
-        if (!setting.show_z_buffer && setting.show_aabb)
+        if (setting.algorithm == Setting::ScanConvertZBuffer)
+        {
+          Rasterizer::RenderPolygonsScanConvertZBuffer(canvas, vertices, polygons);
+        }
+        else if (setting.algorithm == Setting::ScanConvertHZBuffer)
         {
-          for (size_t i = 1; i < haabbs.size(); ++i)
+          Rasterizer::RenderPolygonsScanConvertHZBuffer(canvas, vertices, polygons);
+          if (setting.update_policy == Setting::DEFERRED)
           {
-            glm::ivec2 vmin = glm::max(glm::ivec2(glm::round(haabbs[i].vmin)), glm::ivec2(0, 0));
-            glm::ivec2 vmax = glm::min(glm::ivec2(glm::round(haabbs[i].vmax)), glm::ivec2(canvas.width-1, canvas.height-1));
-            Rasterizer::RenderTangentBresenham(canvas, vmin.x, vmin.y, vmax.x, vmin.y, Color(1.0f, 0.0f, 0.0f));
-            Rasterizer::RenderTangentBresenham(canvas, vmin.x, vmax.y, vmax.x, vmax.y, Color(1.0f, 0.0f, 0.0f));
-            Rasterizer::RenderTangentBresenham(canvas, vmin.x, vmin.y, vmin.x, vmax.y, Color(1.0f, 0.0f, 0.0f));
-            Rasterizer::RenderTangentBresenham(canvas, vmax.x, vmin.y, vmax.x, vmax.y, Color(1.0f, 0.0f, 0.0f));
+            PROFILE_SCOPE(Profiler::Z_PYRAMID);
+            HZBuffer::Flush(*canvas.h_z_buffer);
           }
         }
+        else if (setting.algorithm == Setting::ScanConvertHAABBHZBuffer)
+        {
+          if (setting.screen_haabb)
+          {
+            {
+              PROFILE_SCOPE(Profiler::HAABB_BUILD);
+              HAABB::Build(haabbs, vertices, polygons);
+            }
+            Rasterizer::RenderPolygonsScanConvertHAABBHZBuffer(canvas, vertices, polygons, haabbs);
+            if (!setting.show_z_buffer && setting.show_aabb)
+            {
+              for (size_t i = 1; i < haabbs.size(); ++i)
+              {
+                glm::ivec2 vmin = glm::max(glm::ivec2(glm::round(haabbs[i].vmin)), glm::ivec2(0, 0));
+                glm::ivec2 vmax = glm::min(glm::ivec2(glm::round(haabbs[i].vmax)), glm::ivec2(canvas.width-1, canvas.height-1));
+                RenderRect(canvas, glm::ivec4(vmin.x, vmax.x, vmin.y, vmax.y));
+              }
+            }
+          }
+          else
+          {
+            index.assign(model.polygon_sides.size(), (uint32_t)-1);
+            for (size_t i = 0; i < polygons.size(); ++i)
+            {
+              index[polygons[i].id] = (uint32_t)i;
+            }
+            rects.clear();
+            Rasterizer::RenderPolygonsScanConvertBVHHZBuffer(canvas, vertices, polygons, model.bvh, index, P * MV, setting.enable_clip, rects, temporal ? &visible_leaves[&model] : nullptr);
+            if (!setting.show_z_buffer && setting.show_aabb)
+            {
+              for (const auto& leaf : rects)
+              {
+                RenderRect(canvas, leaf);
+              }
+            }
+          }
+          if (setting.update_policy == Setting::DEFERRED)
+          {
+            PROFILE_SCOPE(Profiler::Z_PYRAMID);
+            HZBuffer::Flush(*canvas.h_z_buffer);
+          }
+        }
+        else if (setting.algorithm == Setting::ScanConvertBVHHZBuffer)
+        {
+          Rasterizer::RenderPolygonsScanConvertZBuffer(canvas, vertices, polygons);
+          {
+            PROFILE_SCOPE(Profiler::Z_PYRAMID);
+            HZBuffer::Update(*canvas.h_z_buffer, rect.x, rect.y, rect.z, rect.w);
+            if (setting.update_policy == Setting::DEFERRED)
+            {
+              HZBuffer::Flush(*canvas.h_z_buffer);
+            }
+          }
+          if (!setting.show_z_buffer && setting.show_aabb)
+          {
+            RenderRect(canvas, rect);
+          }
+        }
+        else if (setting.algorithm == Setting::IntervalScanLine)
+        {
+          if (!setting.show_z_buffer)
+          {
+            Merge(scene_vertices, scene_polygons, vertices, polygons);
+          }
+        }
+        if (query)
+        {
+          pixels[&model] += Rasterizer::statistic.written_pixels - written_pixels;
+        }
       }
-      else if (setting.algorithm == Setting::IntervalScanLine)
+      else
       {
+        ASSERT(setting.display_mode == Setting::WIREFRAME);
         if (!setting.show_z_buffer)
         {
-          Rasterizer::RenderPolygonsIntervalScanLine(canvas, vertices, polygons);
+          index.assign(model.polygon_sides.size(), (uint32_t)-1);
+          for (size_t i = 0; i < polygons.size(); ++i)
+          {
+            index[polygons[i].id] = (uint32_t)i;
+          }
+          Rasterizer::RenderEdgesWireframe(canvas, vertices, polygons, index, model.edges, setting.enable_parallel);
         }
       }
-    }
-    else
-    {
-      ASSERT(setting.display_mode == Setting::WIREFRAME);
-      if (!setting.show_z_buffer)
+    
+      if (!setting.show_z_buffer && setting.show_normal)
       {
-        Rasterizer::RenderPolygonsWireframe(canvas, vertices, polygons);
+        if (merge)
+        {
+          Merge(scene_normal_vertices, scene_normals, polygon_normal_vertices, polygon_normals);
+        }
+        else
+        {
+          Rasterizer::RenderPolygonsWireframe(canvas, polygon_normal_vertices, polygon_normals);
+        }
       }
     }
-    
-    if (!setting.show_z_buffer && setting.show_normal)
-    {
-      Rasterizer::RenderPolygonsWireframe(canvas, polygon_normal_vertices, polygon_normals);
-    }
 
     if (setting.show_z_buffer)
     {
+      ZBuffer::Touch(*canvas.z_buffer, canvas.offsetx, canvas.offsetx + canvas.width - 1, canvas.offsety, canvas.offsety + canvas.height - 1);
       for (int y = canvas.offsety; y < canvas.offsety + canvas.height; ++y)
       {
         for (int x = canvas.offsetx; x < canvas.offsetx + canvas.width; ++x)
@@ -260,4 +925,33 @@
       }
     }
   }
+
+  if (merge && !setting.show_z_buffer)
+  {
+    PROFILE_SCOPE(Profiler::RASTERIZE);
+    Rasterizer::RenderPolygonsIntervalScanLine(canvas, scene_vertices, scene_polygons, setting.enable_parallel);
+    if (setting.show_normal)
+    {
+      Rasterizer::RenderPolygonsWireframe(canvas, scene_normal_vertices, scene_normals);
+    }
+  }
+
+  if (setting.count_overdraw && query)
+  {
+    statistic.covered_pixels = CountCovered(*canvas.z_buffer);
+  }
+
+  if (!Rasterizer::overdraw.empty())
+  {
+    Rasterizer::RenderOverdraw(canvas);
+  }
+
+  visible_pixels.swap(pixels);
+}
+
+void Pipeline::Forget(const Model& model) NOEXCEPT
+{
+  orders.erase(&model);
+  visible_leaves.erase(&model);
+  visible_pixels.erase(&model);
 }
@@ -20,7 +20,41 @@
 // COMMENT: Pipeline System. For Rendering A Scene.
 struct Pipeline
 {
+  // COMMENT: Counters Of The Current Frame For The Scene BVH. A Node Is Culled When Its Box Is Off Screen Or Behind The Z Pyramid.
+  // COMMENT: covered_pixels Counts ZBuffer Pixels Left Nearer Than bgz, Only For The ZBuffer Algorithms And With count_overdraw.
+  // COMMENT: The Occlusion Prepass Tests Every Model That Is Not An Occluder, And Its Time Covers Choosing, Rasterizing And Testing.
+  // COMMENT: Of The Polygons Of Drawn Models, Those Facing Away And Those Wholly Outside The View Volume Never Reach The Rasterizer.
+  struct Statistic
+  {
+    uint32_t input_polygons    = {};
+    uint32_t backface_culled   = {};
+    uint32_t clipped_polygons  = {};
+    uint32_t tested_nodes      = {};
+    uint32_t culled_nodes      = {};
+    uint32_t drawn_models      = {};
+    uint64_t covered_pixels    = {};
+    uint32_t occluder_models   = {};
+    uint32_t occluder_polygons = {};
+    uint32_t prepass_tested    = {};
+    uint32_t prepass_culled    = {};
+    float    prepass_time      = {};
+  };
+
+  static Statistic statistic;
+
+  // COMMENT: Occlusion Query Results. Pixels Of Each Model That Passed The Depth Test Last Frame, Counted While It Was Rasterized.
+  // NOTE: The Frame Fills Its Own Map And Swaps It In When It Ends, So Readers Always See A Whole Frame And Never Wait On One. Culled Models Read 0.
+  // NOTE: Empty Unless A ZBuffer Algorithm Draws In NORMAL Mode. Keys Are Only Looked Up, Never Dereferenced.
+  static std::unordered_map<const Model*, uint64_t> visible_pixels;
+
+  // COMMENT: Reset The Depth Buffers Of canvas That setting.algorithm Reads.
+   static void Clear(const Setting& setting, Canvas& canvas) NOEXCEPT;
+
    static void Render(const Setting& setting, const Shader::Config& config, Canvas& canvas, const Camera& camera, const Scene& scene) NOEXCEPT;
+
+  // COMMENT: Drop What Is Kept Across Frames For model, Before It Is Destroyed. Render Drops It Too Once model Leaves The Scene.
+  // NOTE: Only Needed When A Model May Be Destroyed And Another Allocated At Its Address Between Two Frames. Not While A Frame Renders.
+   static void Forget(const Model& model) NOEXCEPT;
 };
 
 #endif //PIPELINE_H
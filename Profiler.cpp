@@ -0,0 +1,512 @@
+/**
+  ******************************************************************************
+  * @file           : Profiler.cpp
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#include <Profiler.h>
+
+#ifdef ENABLE_PROFILER
+
+#if defined(__linux__)
+  #include <linux/perf_event.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #include <cerrno>
+  #include <cstring>
+#endif
+
+static Profiler::Ring rings[PROFILER_THREADS];
+static std::atomic<int> ring_count = 0;
+static std::atomic<uint64_t> frame = 0;
+
+// NOTE: Threads Past PROFILER_THREADS Share This Ring. Their Times Are Dropped, Not Mixed Into Another Thread's.
+static Profiler::Ring overflow;
+
+static thread_local Profiler::Ring* ring = nullptr;
+static thread_local Profiler::Scope* current = nullptr;
+
+// COMMENT: A Finished Scope Of A Trace Capture. A Negative stage -k Marks The Whole Of Captured Frame k - 1.
+struct Event
+{
+  uint64_t begin = {};
+  uint64_t end   = {};
+  int32_t stage  = {};
+  int32_t thread = {};
+};
+
+// COMMENT: Trace Capture State. Threads Claim Event Slots With One Atomic Add. Capture Hands Over Through capture_pending, And Everything Else Is Only Touched By The Thread Calling EndFrame.
+static std::vector<Event> events;
+static std::atomic<uint32_t> event_count = 0;
+static std::atomic<bool> capturing = false;
+static std::atomic<int> capture_pending = 0;
+static int capture_left = 0;
+static uint64_t capture_frame = 0;
+static uint64_t frame_begin = 0;
+static std::string capture_filename;
+
+// COMMENT: Hardware Counter State. counted_frames Is Only Written By The Thread Calling EndFrame, Which Also Does The Clearing counters_reset Asks For.
+static std::atomic<bool> counters_enabled = false;
+static std::atomic<bool> counters_reset = false;
+static std::atomic<uint32_t> counters_available = 0;
+static std::atomic<bool> counters_warned = false;
+static uint64_t counted_frames = 0;
+
+// COMMENT: The Calling Thread's Counters, Opened As One Group So A Single read Returns Them All. slots[c] Is Counter c's Place In That read, Or -1.
+struct CounterGroup
+{
+  bool opened = false;
+  int fd = -1;
+  int size = 0;
+  int slots[Profiler::COUNTER_COUNT] = { -1, -1, -1, -1, -1 };
+};
+
+static thread_local CounterGroup group;
+
+// NOTE: A Counter The Machine Lacks Is Left Out Instead Of Failing The Group, So A Virtual Machine Without Cache Events Still Counts Cycles.
+// NOTE: The Kernel Schedules A Group As A Whole, So Even When perf Multiplexes It With Other Users, Ratios Such As IPC Stay Exact.
+static void OpenCounters() NOEXCEPT
+{
+  group.opened = true;
+#if defined(__linux__)
+  struct Event
+  {
+    uint32_t type;
+    uint64_t config;
+  };
+  static const Event EVENTS[Profiler::COUNTER_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  };
+
+  int error = 0;
+  uint32_t available = 0;
+  for (int c = 0; c < Profiler::COUNTER_COUNT; ++c)
+  {
+    // NOTE: User Mode Only, Which perf_event_paranoid Up To 2 Allows Without Privileges.
+    perf_event_attr attr = {};
+    attr.size           = sizeof(attr);
+    attr.type           = EVENTS[c].type;
+    attr.config         = EVENTS[c].config;
+    attr.read_format    = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    const int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, group.fd, 0);
+    if (fd < 0)
+    {
+      error = errno;
+      continue;
+    }
+    if (group.fd < 0)
+    {
+      group.fd = fd;
+    }
+    group.slots[c] = group.size++;
+    available |= 1u << c;
+  }
+  counters_available.fetch_or(available, std::memory_order_relaxed);
+  if (available == 0 && !counters_warned.exchange(true, std::memory_order_relaxed))
+  {
+    Warn("Can Not Open Hardware Counters: %s", strerror(error));
+  }
+#else
+  if (!counters_warned.exchange(true, std::memory_order_relaxed))
+  {
+    Warn("Hardware Counters Need Linux perf_event_open");
+  }
+#endif
+}
+
+// COMMENT: Current Values Of The Calling Thread's Counters, 0 For Those It Lacks. false When It Has None.
+NODISCARD static bool ReadCounters(uint64_t counts[Profiler::COUNTER_COUNT]) NOEXCEPT
+{
+  if (!group.opened)
+  {
+    OpenCounters();
+  }
+#if defined(__linux__)
+  if (group.fd < 0)
+  {
+    return false;
+  }
+  // NOTE: A Group Read Is The Number Of Counters, Then Their Values In Opening Order.
+  uint64_t values[1 + Profiler::COUNTER_COUNT];
+  const ssize_t size = (ssize_t)(sizeof(uint64_t) * (1 + group.size));
+  if (read(group.fd, values, size) != size)
+  {
+    return false;
+  }
+  for (int c = 0; c < Profiler::COUNTER_COUNT; ++c)
+  {
+    counts[c] = group.slots[c] < 0 ? 0 : values[1 + group.slots[c]];
+  }
+  return true;
+#else
+  (void)counts;
+  return false;
+#endif
+}
+
+// COMMENT: The Calling Thread's Ring, Registered On First Use.
+NODISCARD static Profiler::Ring* Register() NOEXCEPT
+{
+  if (ring == nullptr)
+  {
+    const int index = ring_count.fetch_add(1, std::memory_order_relaxed);
+    ring = index < PROFILER_THREADS ? &rings[index] : &overflow;
+  }
+  return ring;
+}
+
+NODISCARD static int32_t ThreadIndex() NOEXCEPT
+{
+  Profiler::Ring* const self = Register();
+  return self == &overflow ? PROFILER_THREADS : (int32_t)(self - rings);
+}
+
+static void Push(const int32_t stage, const uint64_t begin, const uint64_t end) NOEXCEPT
+{
+  const uint32_t index = event_count.fetch_add(1, std::memory_order_relaxed);
+  if (index < events.size())
+  {
+    events[index] = Event{ .begin = begin, .end = end, .stage = stage, .thread = ThreadIndex() };
+  }
+}
+
+// COMMENT: Chrome Trace Event Format: Complete Events With Microsecond Times, Plus Thread Names.
+// Ref: https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+static void Write() NOEXCEPT
+{
+  const uint32_t count = std::min(event_count.load(std::memory_order_acquire), (uint32_t)events.size());
+  const uint32_t dropped = event_count.load(std::memory_order_relaxed) - count;
+
+  FILE* fp = fopen(capture_filename.c_str(), "wb");
+  if (fp == nullptr)
+  {
+    Warn("Can Not Open %s", capture_filename);
+    return;
+  }
+
+  uint64_t origin = UINT64_MAX;
+  std::vector<bool> threads(PROFILER_THREADS + 1, false);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    origin = std::min(origin, events[i].begin);
+    threads[events[i].thread] = true;
+  }
+
+  fmt::fprintf(fp, "{\"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped_events\": %u}, \"traceEvents\": [\n", dropped);
+  bool first = true;
+  for (int thread = 0; thread <= PROFILER_THREADS; ++thread)
+  {
+    if (threads[thread])
+    {
+      fmt::fprintf(fp, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"Thread %d\"}}", first ? "" : ",\n", thread, thread);
+      first = false;
+    }
+  }
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const Event& event = events[i];
+    const std::string name = event.stage < 0 ? fmt::sprintf("Frame %llu", (unsigned long long)(capture_frame + (uint64_t)-event.stage - 1)) : std::string(Profiler::Name((Profiler::Stage)event.stage));
+    fmt::fprintf(fp, "%s{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+      first ? "" : ",\n", name, event.stage < 0 ? "frame" : "stage", (double)(event.begin - origin) * 1e-3, (double)(event.end - event.begin) * 1e-3, event.thread);
+    first = false;
+  }
+  fmt::fprintf(fp, "\n]}\n");
+
+  if (fclose(fp) != 0)
+  {
+    Warn("Can Not Close %s", capture_filename);
+    return;
+  }
+  Info("Wrote %u Trace Events To %s, %u Dropped", count, capture_filename, dropped);
+}
+
+float Profiler::history[STAGE_COUNT][PROFILER_HISTORY] = {};
+int Profiler::offset = 0;
+double Profiler::counter_history[COUNTER_COUNT][STAGE_COUNT][PROFILER_HISTORY] = {};
+uint64_t Profiler::frame_counts[STAGE_COUNT][COUNTER_COUNT] = {};
+
+NODISCARD const char* Profiler::Name(const Stage stage) NOEXCEPT
+{
+  switch (stage)
+  {
+    case TRANSFORM:   return "Transform";
+    case CULL:        return "Cull";
+    case SHADE:       return "Shade";
+    case CLIP:        return "Clip";
+    case VIEWPORT:    return "Viewport";
+    case HAABB_BUILD: return "HAABB Build";
+    case RASTERIZE:   return "Rasterize";
+    case Z_PYRAMID:   return "Z Pyramid";
+    case PRESENT:     return "Present";
+    default:          return "Unknown";
+  }
+}
+
+NODISCARD const char* Profiler::Name(const Counter counter) NOEXCEPT
+{
+  switch (counter)
+  {
+    case CYCLES:        return "Cycles";
+    case INSTRUCTIONS:  return "Instructions";
+    case L1D_MISSES:    return "L1D Misses";
+    case LLC_MISSES:    return "LLC Misses";
+    case BRANCH_MISSES: return "Branch Misses";
+    default:            return "Unknown";
+  }
+}
+
+NODISCARD uint64_t Profiler::Now() NOEXCEPT
+{
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// NOTE: Counters Are Read Outside The Timed Span, So The Reads Cost The Scope No Time. The Enclosing Scope Pays For Them.
+Profiler::Scope::Scope(const Stage stage) NOEXCEPT
+  : stage(stage), excluded(0), parent(current)
+{
+  current = this;
+  counted = counters_enabled.load(std::memory_order_relaxed) && ReadCounters(counts);
+  start = Now();
+}
+
+Profiler::Scope::~Scope() NOEXCEPT
+{
+  const uint64_t end = Now();
+  const uint64_t elapsed = end - start;
+  Record(stage, elapsed - std::min(excluded, elapsed));
+  uint64_t end_counts[COUNTER_COUNT];
+  if (counted && ReadCounters(end_counts))
+  {
+    uint64_t delta[COUNTER_COUNT];
+    for (int c = 0; c < COUNTER_COUNT; ++c)
+    {
+      const uint64_t counted_total = end_counts[c] - counts[c];
+      delta[c] = counted_total - std::min(excluded_counts[c], counted_total);
+      if (parent != nullptr && parent->counted)
+      {
+        parent->excluded_counts[c] += counted_total;
+      }
+    }
+    RecordCounts(stage, delta);
+  }
+  if (capturing.load(std::memory_order_relaxed))
+  {
+    Push(stage, start, end);
+  }
+  if (parent != nullptr)
+  {
+    parent->excluded += elapsed;
+  }
+  current = parent;
+}
+
+// COMMENT: Row Of The Current Frame In The Calling Thread's Ring, Cleared If This Is The Frame's First Write To It.
+// NOTE: Only This Thread Writes Its Ring, So Plain Loads And Stores Suffice. Release Publishes The Cleared Row Before Its Tag.
+NODISCARD static int Row() NOEXCEPT
+{
+  const uint64_t f = frame.load(std::memory_order_relaxed);
+  const int row = (int)(f % PROFILER_RING);
+  if (ring->tags[row].load(std::memory_order_relaxed) != f + 1)
+  {
+    for (int s = 0; s < Profiler::STAGE_COUNT; ++s)
+    {
+      ring->ns[row][s].store(0, std::memory_order_relaxed);
+      for (int c = 0; c < Profiler::COUNTER_COUNT; ++c)
+      {
+        ring->counts[row][s][c].store(0, std::memory_order_relaxed);
+      }
+    }
+    ring->tags[row].store(f + 1, std::memory_order_release);
+  }
+  return row;
+}
+
+void Profiler::Record(const Stage stage, const uint64_t ns) NOEXCEPT
+{
+  if (Register() == &overflow)
+  {
+    return;
+  }
+  std::atomic<uint64_t>& total = ring->ns[Row()][stage];
+  total.store(total.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+}
+
+void Profiler::RecordCounts(const Stage stage, const uint64_t counts[COUNTER_COUNT]) NOEXCEPT
+{
+  if (Register() == &overflow)
+  {
+    return;
+  }
+  const int row = Row();
+  for (int c = 0; c < COUNTER_COUNT; ++c)
+  {
+    std::atomic<uint64_t>& total = ring->counts[row][stage][c];
+    total.store(total.load(std::memory_order_relaxed) + counts[c], std::memory_order_relaxed);
+  }
+}
+
+void Profiler::EndFrame() NOEXCEPT
+{
+  const uint64_t f = frame.fetch_add(1, std::memory_order_acq_rel);
+  const int row = (int)(f % PROFILER_RING);
+  const int count = std::min(ring_count.load(std::memory_order_acquire), PROFILER_THREADS);
+
+  // COMMENT: Tags Are Frame + 1, So A Row Never Written Reads As No Frame At All.
+  if (counters_reset.exchange(false, std::memory_order_acquire))
+  {
+    std::fill_n(&counter_history[0][0][0], (int)COUNTER_COUNT * (int)STAGE_COUNT * PROFILER_HISTORY, 0.0);
+    counted_frames = 0;
+  }
+
+  uint64_t totals[STAGE_COUNT] = {};
+  std::fill_n(&frame_counts[0][0], (int)STAGE_COUNT * (int)COUNTER_COUNT, 0);
+  for (int i = 0; i < count; ++i)
+  {
+    if (rings[i].tags[row].load(std::memory_order_acquire) != f + 1)
+    {
+      continue;
+    }
+    for (int s = 0; s < STAGE_COUNT; ++s)
+    {
+      totals[s] += rings[i].ns[row][s].load(std::memory_order_relaxed);
+      for (int c = 0; c < COUNTER_COUNT; ++c)
+      {
+        frame_counts[s][c] += rings[i].counts[row][s][c].load(std::memory_order_relaxed);
+      }
+    }
+  }
+  for (int s = 0; s < STAGE_COUNT; ++s)
+  {
+    history[s][offset] = (float)((double)totals[s] * 1e-6);
+  }
+  // NOTE: Frames Not Counted Leave counter_history Alone, So After Stopping It Still Holds The Last Counted Frames.
+  if (counters_enabled.load(std::memory_order_relaxed))
+  {
+    for (int c = 0; c < COUNTER_COUNT; ++c)
+    {
+      for (int s = 0; s < STAGE_COUNT; ++s)
+      {
+        counter_history[c][s][offset] = (double)frame_counts[s][c];
+      }
+    }
+    ++counted_frames;
+  }
+  offset = (offset + 1) % PROFILER_HISTORY;
+
+  // COMMENT: A Capture Starts At A Frame Boundary And Ends At One. Frames Are Recorded As Events Of Their Own, Numbered From The First Captured.
+  const uint64_t now = Now();
+  if (capturing.load(std::memory_order_relaxed))
+  {
+    Push(-(int32_t)(f - capture_frame + 1), frame_begin, now);
+    if (--capture_left == 0)
+    {
+      // NOTE: Written Before capturing Clears, As Capture May Then Resize events From Another Thread.
+      Write();
+      capturing.store(false, std::memory_order_release);
+    }
+  }
+  else if (const int pending = capture_pending.load(std::memory_order_acquire); pending > 0)
+  {
+    // NOTE: capturing Is Set Before capture_pending Is Cleared, So Capturing Never Reads false In Between.
+    capture_left = pending;
+    capture_frame = f + 1;
+    event_count.store(0, std::memory_order_relaxed);
+    capturing.store(true, std::memory_order_release);
+    capture_pending.store(0, std::memory_order_release);
+  }
+  frame_begin = Now();
+}
+
+void Profiler::Capture(const int frames, const char* filename) NOEXCEPT
+{
+  if (Capturing() || frames <= 0)
+  {
+    return;
+  }
+  events.resize(PROFILER_EVENTS);
+  capture_filename = filename;
+  capture_pending.store(frames, std::memory_order_release);
+}
+
+NODISCARD bool Profiler::Capturing() NOEXCEPT
+{
+  return capturing.load(std::memory_order_acquire) || capture_pending.load(std::memory_order_acquire) > 0;
+}
+
+void Profiler::EnableCounters(const bool enable) NOEXCEPT
+{
+  if (enable && !counters_enabled.load(std::memory_order_relaxed))
+  {
+    counters_reset.store(true, std::memory_order_release);
+  }
+  counters_enabled.store(enable, std::memory_order_relaxed);
+}
+
+NODISCARD bool Profiler::CountersEnabled() NOEXCEPT
+{
+  return counters_enabled.load(std::memory_order_relaxed);
+}
+
+NODISCARD uint32_t Profiler::CountersAvailable() NOEXCEPT
+{
+  return counters_available.load(std::memory_order_relaxed);
+}
+
+NODISCARD double Profiler::CounterAverage(const Stage stage, const Counter counter) NOEXCEPT
+{
+  const uint64_t frames = std::min(counted_frames, (uint64_t)PROFILER_HISTORY);
+  if (frames == 0)
+  {
+    return 0.0;
+  }
+  double sum = 0.0;
+  for (int i = 0; i < PROFILER_HISTORY; ++i)
+  {
+    sum += counter_history[counter][stage][i];
+  }
+  return sum / (double)frames;
+}
+
+NODISCARD float Profiler::Average(const Stage stage) NOEXCEPT
+{
+  // NOTE: Slots Not Yet Filled Hold 0, So Only The Frame Count Needs Clamping.
+  const uint64_t frames = std::min(frame.load(std::memory_order_relaxed), (uint64_t)PROFILER_HISTORY);
+  if (frames == 0)
+  {
+    return 0.0f;
+  }
+  float sum = 0.0f;
+  for (int i = 0; i < PROFILER_HISTORY; ++i)
+  {
+    sum += history[stage][i];
+  }
+  return sum / (float)frames;
+}
+
+void Profiler::Summarize(Summary& summary) NOEXCEPT
+{
+  std::copy_n(&history[0][0], (int)STAGE_COUNT * PROFILER_HISTORY, &summary.history[0][0]);
+  summary.offset = offset;
+  for (int s = 0; s < STAGE_COUNT; ++s)
+  {
+    summary.averages[s] = Average((Stage)s);
+    for (int c = 0; c < COUNTER_COUNT; ++c)
+    {
+      summary.counter_averages[s][c] = CounterAverage((Stage)s, (Counter)c);
+    }
+  }
+}
+
+#endif
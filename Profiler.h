@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+  * @file           : Profiler.h
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Common.h>
+
+#include <atomic>
+
+// COMMENT: Frames Each Thread's Ring Holds, Frames Of History Kept For The Graphs, And Threads That Can Record.
+CONSTEXPR int PROFILER_RING    = 4;
+CONSTEXPR int PROFILER_HISTORY = 240;
+CONSTEXPR int PROFILER_THREADS = 64;
+
+// COMMENT: Scopes A Trace Capture Can Hold. Later Ones Are Counted As Dropped.
+CONSTEXPR int PROFILER_EVENTS  = 1 << 20;
+
+// COMMENT: Profiler System. Scoped Timers Around The Pipeline Stages, In Nanoseconds.
+// NOTE: Every Thread Adds To Its Own Ring Of Per Frame Totals, So Recording Takes No Lock And Shares No Cache Line.
+// NOTE: Scopes Nest And Time Is Exclusive: A Scope Inside Another Pauses The Outer One, So The Stages Of A Frame Add Up To Its Instrumented Time.
+// NOTE: Without ENABLE_PROFILER Nothing Here Is Compiled And PROFILE_SCOPE Expands To Nothing.
+#ifdef ENABLE_PROFILER
+
+struct Profiler
+{
+  enum Stage
+  {
+    TRANSFORM,
+    CULL,
+    SHADE,
+    CLIP,
+    VIEWPORT,
+    HAABB_BUILD,
+    RASTERIZE,
+    Z_PYRAMID,
+    // NOTE: With The Render Thread, Only The Main Thread Presents, So A Frame's PRESENT Is The Copying And Displaying Done While It Rendered.
+    PRESENT,
+    STAGE_COUNT,
+  };
+
+  // COMMENT: Hardware Counters Read Around Every Scope, In User Mode Only.
+  enum Counter
+  {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    COUNTER_COUNT,
+  };
+
+  // COMMENT: Row frame % PROFILER_RING Holds The Totals Of frame, Once tags Says So. The Owner Clears A Row When It First Writes A New Frame To It.
+  struct alignas(64) Ring
+  {
+    std::atomic<uint64_t> tags[PROFILER_RING]              = {};
+    std::atomic<uint64_t> ns[PROFILER_RING][STAGE_COUNT]   = {};
+    std::atomic<uint64_t> counts[PROFILER_RING][STAGE_COUNT][COUNTER_COUNT] = {};
+  };
+
+  struct Scope
+  {
+    Stage    stage    = {};
+    uint64_t start    = {};
+    uint64_t excluded = {};
+    Scope*   parent   = {};
+
+    // NOTE: Counter Values Are Only Read When Counting Was On As The Scope Opened.
+    bool     counted  = {};
+    uint64_t counts[COUNTER_COUNT]          = {};
+    uint64_t excluded_counts[COUNTER_COUNT] = {};
+
+    explicit Scope(Stage stage) NOEXCEPT;
+    ~Scope() NOEXCEPT;
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+  // COMMENT: What The Profiler Panel Shows: history With Its offset, And The Averages Over It. Taken By Summarize.
+  struct Summary
+  {
+    float history[STAGE_COUNT][PROFILER_HISTORY]        = {};
+    int offset                                          = {};
+    float averages[STAGE_COUNT]                         = {};
+    double counter_averages[STAGE_COUNT][COUNTER_COUNT] = {};
+  };
+
+  // COMMENT: Milliseconds Per Stage Of The Last PROFILER_HISTORY Finished Frames, Oldest At offset.
+  // NOTE: Like counter_history And frame_counts, Only The Thread Calling EndFrame May Read It. Other Threads Are Handed A Summary.
+  static float history[STAGE_COUNT][PROFILER_HISTORY];
+  static int offset;
+
+  // COMMENT: Counts Per Stage Of The Last PROFILER_HISTORY Finished Frames, Indexed As history, And Of The Last Finished Frame Alone.
+  static double counter_history[COUNTER_COUNT][STAGE_COUNT][PROFILER_HISTORY];
+  static uint64_t frame_counts[STAGE_COUNT][COUNTER_COUNT];
+
+  NODISCARD static const char* Name(Stage stage) NOEXCEPT;
+
+  NODISCARD static const char* Name(Counter counter) NOEXCEPT;
+
+  NODISCARD static uint64_t Now() NOEXCEPT;
+
+  // COMMENT: Add ns To stage In The Calling Thread's Ring.
+   static void Record(Stage stage, uint64_t ns) NOEXCEPT;
+
+  // COMMENT: Add counts To stage In The Calling Thread's Ring.
+   static void RecordCounts(Stage stage, const uint64_t counts[COUNTER_COUNT]) NOEXCEPT;
+
+  // COMMENT: Close The Current Frame. Its Totals Over Every Thread Are Appended To history.
+  // NOTE: Called Once Per Frame By The Thread That Drives Rendering, After Every Worker Of The Frame Is Done.
+   static void EndFrame() NOEXCEPT;
+
+  // COMMENT: Mean Milliseconds Of stage Over history.
+  NODISCARD static float Average(Stage stage) NOEXCEPT;
+
+  // COMMENT: Record Every Scope Of Every Thread Over The frames Frames After The Current One, Then Write Them To filename As Chrome Trace Event JSON.
+  // NOTE: The Event Buffer Is Allocated Here, And The File Is Written After The Last Captured Frame, So Neither Lands Inside A Captured Frame.
+   static void Capture(int frames, const char* filename) NOEXCEPT;
+
+  NODISCARD static bool Capturing() NOEXCEPT;
+
+  // COMMENT: Start Or Stop Reading The Hardware Counters. Starting Clears counter_history.
+  // NOTE: Each Thread Opens Its Counters With perf_event_open On Its First Scope After This, So Only Linux Has Them. Where They Can Not Be Opened, Scopes Just Go On Timing.
+   static void EnableCounters(bool enable) NOEXCEPT;
+
+  NODISCARD static bool CountersEnabled() NOEXCEPT;
+
+  // COMMENT: Bit c Is Set When Counter c Could Be Opened. 0 Until A Thread Has Tried, Or When None Could.
+  NODISCARD static uint32_t CountersAvailable() NOEXCEPT;
+
+  // COMMENT: Mean Count Of counter In stage Per Frame, Over The Frames Of counter_history Counted Since Enabling.
+  NODISCARD static double CounterAverage(Stage stage, Counter counter) NOEXCEPT;
+
+  // COMMENT: Copy history And Its Averages Into summary, On The Thread Calling EndFrame.
+   static void Summarize(Summary& summary) NOEXCEPT;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) const Profiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(stage)
+#define PROFILE_END_FRAME() Profiler::EndFrame()
+
+#else
+
+#define PROFILE_SCOPE(stage)
+#define PROFILE_END_FRAME()
+
+#endif
+
+#endif //PROFILER_H
@@ -11,21 +11,72 @@
 
 
 #include <Rasterizer.h>
+#include <Transformer.h>
 #include <Acceleration/HZBuffer.h>
+#include <Parallel.h>
+#include <Profiler.h>
+
+#if defined(__SSE2__) || defined(__AVX2__) || defined(__AVX512F__)
+  #include <immintrin.h>
+#endif
+
+Rasterizer::Statistic Rasterizer::statistic = {};
+std::vector<uint16_t> Rasterizer::overdraw = {};
+
+// COMMENT: Split The Canvas Into Bands Of Whole Frame Buffer Tile Rows, So No Two Bands Touch The Same Tile. Band b Covers Rows [starts[b], starts[b + 1]).
+static void TileRowBands(const Canvas& canvas, std::vector<int>& starts) NOEXCEPT
+{
+  starts.clear();
+  for (int y = 0; y < canvas.height; y = ((canvas.offsety + y) / TILE_SIZE + 1) * TILE_SIZE - canvas.offsety)
+  {
+    starts.push_back(y);
+  }
+  starts.push_back(canvas.height);
+}
+
+template<SDL_PixelFormat Format>
+static void MapColorsAs(std::vector<Polygon>& polygons) NOEXCEPT
+{
+  for (auto& polygon : polygons)
+  {
+    polygon.mapped_color = PixelWriter<Format>::Map(Rasterizer::Quantize(polygon.color.r), Rasterizer::Quantize(polygon.color.g), Rasterizer::Quantize(polygon.color.b));
+  }
+}
 
 NODISCARD  Uint32 Rasterizer::MapColor(const FrameBuffer& frame_buffer, const Color& color) NOEXCEPT
 {
-  return SDL_MapRGB(
-    frame_buffer.format, nullptr,
-    (Uint8)(255.999f * std::clamp(color.r, 0.0f, 1.0f)),
-    (Uint8)(255.999f * std::clamp(color.g, 0.0f, 1.0f)),
-    (Uint8)(255.999f * std::clamp(color.b, 0.0f, 1.0f))
-  );
+  const Uint8 r = Quantize(color.r);
+  const Uint8 g = Quantize(color.g);
+  const Uint8 b = Quantize(color.b);
+  switch (frame_buffer.format->format)
+  {
+    case SDL_PIXELFORMAT_XRGB8888: return PixelWriter<SDL_PIXELFORMAT_XRGB8888>::Map(r, g, b);
+    case SDL_PIXELFORMAT_ARGB8888: return PixelWriter<SDL_PIXELFORMAT_ARGB8888>::Map(r, g, b);
+    case SDL_PIXELFORMAT_ABGR8888: return PixelWriter<SDL_PIXELFORMAT_ABGR8888>::Map(r, g, b);
+    default: return SDL_MapRGB(frame_buffer.format, nullptr, r, g, b);
+  }
+}
+
+void Rasterizer::MapColors(const FrameBuffer& frame_buffer, std::vector<Polygon>& polygons) NOEXCEPT
+{
+  switch (frame_buffer.format->format)
+  {
+    case SDL_PIXELFORMAT_XRGB8888: MapColorsAs<SDL_PIXELFORMAT_XRGB8888>(polygons); break;
+    case SDL_PIXELFORMAT_ARGB8888: MapColorsAs<SDL_PIXELFORMAT_ARGB8888>(polygons); break;
+    case SDL_PIXELFORMAT_ABGR8888: MapColorsAs<SDL_PIXELFORMAT_ABGR8888>(polygons); break;
+    default:
+      for (auto& polygon : polygons)
+      {
+        polygon.mapped_color = SDL_MapRGB(frame_buffer.format, nullptr, Quantize(polygon.color.r), Quantize(polygon.color.g), Quantize(polygon.color.b));
+      }
+    break;
+  }
 }
 
 void Rasterizer::RenderPixel(const FrameBuffer& frame_buffer, const int x, const int y, const Uint32 color) NOEXCEPT
 {
   ASSERT(0 <= x && x < frame_buffer.width && 0 <= y && y < frame_buffer.height);
+  FrameBuffer::Touch(frame_buffer, x >> TILE_SHIFT, y >> TILE_SHIFT);
   frame_buffer.buffer[frame_buffer.width * y + x] = color;
 }
 
@@ -37,10 +88,8 @@ void Rasterizer::RenderPixel(const FrameBuffer& frame_buffer, const int x, const
 void Rasterizer::RenderSegment(const FrameBuffer& frame_buffer, const int xmin, const int xmax, const int y, const Uint32 color) NOEXCEPT
 {
   ASSERT(0 <= xmin && xmin <= xmax && xmax < frame_buffer.width && 0 <= y && y < frame_buffer.height);
-  for (int x = xmin; x <= xmax; ++x)
-  {
-    RenderPixel(frame_buffer, x, y, color);
-  }
+  FrameBuffer::Touch(frame_buffer, xmin, xmax, y, y);
+  std::fill(frame_buffer.buffer + frame_buffer.width * y + xmin, frame_buffer.buffer + frame_buffer.width * y + xmax + 1, color);
 }
 
 void Rasterizer::RenderSegment(const FrameBuffer& frame_buffer, const int xmin, const int xmax, const int y, const Color& color) NOEXCEPT
@@ -48,153 +97,414 @@ void Rasterizer::RenderSegment(const FrameBuffer& frame_buffer, const int xmin,
   RenderSegment(frame_buffer, xmin, xmax, y, MapColor(frame_buffer, color));
 }
 
-void Rasterizer::RenderTangentDDA(const Canvas& canvas, int x0, int y0, int x1, int y1, const Uint32& color) NOEXCEPT
+// COMMENT: Per Pixel Depth Test Of Lanes [begin, end). Lane k Sits At zrow[k] And crow[k]. Returns How Many Lanes Passed.
+// NOTE: Unless orow Is nullptr, Every Lane Takes The Scalar Tail, Which Also Counts Its Writes In orow[k].
+NODISCARD static int TestSpan(float* zrow, Uint32* crow, uint16_t* orow, const int begin, const int end, const float z, const float dzdx, const Uint32 color) NOEXCEPT
 {
-  x0 += canvas.offsetx, y0 += canvas.offsety, x1 += canvas.offsetx, y1 += canvas.offsety;
-
-  int len = std::max(std::abs(x1 - x0), std::abs(y1 - y0));
+  int i = begin;
+  int written = 0;
+  const int vector_end = orow == nullptr ? end : begin;
+  Rasterizer::statistic.tested_pixels += end - begin;
 
-  float dx = (float)(x1 - x0) / (float)len;
-  float dy = (float)(y1 - y0) / (float)len;
-  
-  float x = x0, y = y0;
+  // COMMENT: Depth Of Lane k Is z + dzdx * k. Lanes Pass Where The Stored Depth Is Farther.
+#if defined(__AVX512F__)
+  {
+    const __m512 zv = _mm512_set1_ps(z);
+    const __m512 dv = _mm512_set1_ps(dzdx);
+    const __m512i cv = _mm512_set1_epi32((int)color);
+    __m512 iv = _mm512_add_ps(_mm512_set1_ps((float)i), _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f));
+    for (; i + 16 <= vector_end; i += 16)
+    {
+      const __m512 curz = _mm512_add_ps(zv, _mm512_mul_ps(dv, iv));
+      const __mmask16 mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(zrow + i), curz, _CMP_GT_OQ);
+      _mm512_mask_storeu_ps(zrow + i, mask, curz);
+      _mm512_mask_storeu_epi32(crow + i, mask, cv);
+      written += __builtin_popcount((unsigned)mask);
+      iv = _mm512_add_ps(iv, _mm512_set1_ps(16.0f));
+    }
+  }
+#elif defined(__AVX2__)
+  {
+    const __m256 zv = _mm256_set1_ps(z);
+    const __m256 dv = _mm256_set1_ps(dzdx);
+    const __m256i cv = _mm256_set1_epi32((int)color);
+    __m256 iv = _mm256_add_ps(_mm256_set1_ps((float)i), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+    for (; i + 8 <= vector_end; i += 8)
+    {
+      const __m256 curz = _mm256_add_ps(zv, _mm256_mul_ps(dv, iv));
+      const __m256i mask = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(zrow + i), curz, _CMP_GT_OQ));
+      _mm256_maskstore_ps(zrow + i, mask, curz);
+      _mm256_maskstore_epi32((int*)(crow + i), mask, cv);
+      written += __builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+      iv = _mm256_add_ps(iv, _mm256_set1_ps(8.0f));
+    }
+  }
+#elif defined(__SSE2__)
+  {
+    // NOTE: SSE2 Has No Masked Store, So Blend With The Loaded Values And Store Back. 2 x 4 Lanes Per Iteration.
+    const __m128 zv = _mm_set1_ps(z);
+    const __m128 dv = _mm_set1_ps(dzdx);
+    const __m128i cv = _mm_set1_epi32((int)color);
+    __m128 iv0 = _mm_add_ps(_mm_set1_ps((float)i), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    __m128 iv1 = _mm_add_ps(_mm_set1_ps((float)i), _mm_setr_ps(4.0f, 5.0f, 6.0f, 7.0f));
+    for (; i + 8 <= vector_end; i += 8)
+    {
+      const __m128 curz0 = _mm_add_ps(zv, _mm_mul_ps(dv, iv0));
+      const __m128 curz1 = _mm_add_ps(zv, _mm_mul_ps(dv, iv1));
+      const __m128 oldz0 = _mm_loadu_ps(zrow + i);
+      const __m128 oldz1 = _mm_loadu_ps(zrow + i + 4);
+      const __m128 mask0 = _mm_cmpgt_ps(oldz0, curz0);
+      const __m128 mask1 = _mm_cmpgt_ps(oldz1, curz1);
+      const int bits = _mm_movemask_ps(mask0) | (_mm_movemask_ps(mask1) << 4);
+      if (bits != 0)
+      {
+        written += __builtin_popcount((unsigned)bits);
+        _mm_storeu_ps(zrow + i, _mm_or_ps(_mm_and_ps(mask0, curz0), _mm_andnot_ps(mask0, oldz0)));
+        _mm_storeu_ps(zrow + i + 4, _mm_or_ps(_mm_and_ps(mask1, curz1), _mm_andnot_ps(mask1, oldz1)));
+        const __m128i cmask0 = _mm_castps_si128(mask0);
+        const __m128i cmask1 = _mm_castps_si128(mask1);
+        const __m128i oldc0 = _mm_loadu_si128((const __m128i*)(crow + i));
+        const __m128i oldc1 = _mm_loadu_si128((const __m128i*)(crow + i + 4));
+        _mm_storeu_si128((__m128i*)(crow + i), _mm_or_si128(_mm_and_si128(cmask0, cv), _mm_andnot_si128(cmask0, oldc0)));
+        _mm_storeu_si128((__m128i*)(crow + i + 4), _mm_or_si128(_mm_and_si128(cmask1, cv), _mm_andnot_si128(cmask1, oldc1)));
+      }
+      iv0 = _mm_add_ps(iv0, _mm_set1_ps(8.0f));
+      iv1 = _mm_add_ps(iv1, _mm_set1_ps(8.0f));
+    }
+  }
+#endif
 
-  for (int i = 0; i < len && 0 <= x && x < canvas.frame_buffer->width && 0 <= y && y < canvas.frame_buffer->height; ++i)
+  // COMMENT: Scalar Tail. The Lane Index Counts In Float, Which Is Exact, So Lanes Match The Vector Formula Without A Conversion Each.
+  for (float k = (float)i; i < end; ++i, k += 1.0f)
   {
-    RenderPixel(*canvas.frame_buffer, (int)x, (int)y, color);
-    x += dx, y += dy;
+    const float curz = z + dzdx * k;
+    if (zrow[i] > curz)
+    {
+      zrow[i] = curz;
+      crow[i] = color;
+      ++written;
+      if (orow != nullptr)
+      {
+        ++orow[i];
+      }
+    }
   }
+  return written;
 }
 
-void Rasterizer::RenderTangentDDA(const Canvas& canvas, const int x0, const int y0, const int x1, const int y1, const Color& color) NOEXCEPT
+// COMMENT: Rescan The Stale Rows Of A Cell And Rebuild Its zmax.
+// NOTE: Deferred Until A Piece Could Be Rejected, Since Reading A Row Right After Its Masked Stores Stalls On Store Forwarding.
+static void RefreshCell(const ZBuffer& z_buffer, const int cx, const int cy) NOEXCEPT
 {
-  RenderTangentDDA(canvas, x0, y0, x1, y1, MapColor(*canvas.frame_buffer, color));
+  float* rows = z_buffer.row_zmax + ((cy * z_buffer.cell_cols + cx) << CELL_SHIFT);
+  uint8_t& stale = z_buffer.stale[cy * z_buffer.cell_cols + cx];
+  const int width = std::min(CELL_SIZE, z_buffer.width - (cx << CELL_SHIFT));
+  for (int row = 0; row < CELL_SIZE; ++row)
+  {
+    if (stale & (1u << row))
+    {
+      const float* cell = z_buffer.buffer[(cy << CELL_SHIFT) + row] + (cx << CELL_SHIFT);
+      float hi = cell[0];
+      for (int i = 1; i < width; ++i)
+      {
+        hi = std::max(hi, cell[i]);
+      }
+      rows[row] = hi;
+    }
+  }
+  stale = 0;
+
+  float hi = rows[0];
+  for (int row = 1; row < CELL_SIZE; ++row)
+  {
+    hi = std::max(hi, rows[row]);
+  }
+  z_buffer.zmax[cy * z_buffer.cell_cols + cx] = hi;
 }
 
-void Rasterizer::RenderTangentBresenham(const Canvas& canvas, int x0, int y0, int x1, int y1, const Uint32& color) NOEXCEPT
+void Rasterizer::RenderSpan(const Canvas& canvas, const int xmin, const int xmax, const int y, const float z, const float dzdx, const Uint32 color) NOEXCEPT
 {
-  x0 += canvas.offsetx, y0 += canvas.offsety, x1 += canvas.offsetx, y1 += canvas.offsety;
+  if (xmin > xmax) { return; }
 
-  int dx = x1 - x0;
-  int dy = y1 - y0;
+  ASSERT(0 <= xmin && xmax < canvas.width && 0 <= y && y < canvas.height);
 
-  if (dx == 0 && dy == 0)
+  const ZBuffer& z_buffer = *canvas.z_buffer;
+  ZBuffer::Touch(z_buffer, xmin, xmax, y, y);
+  FrameBuffer::Touch(*canvas.frame_buffer, canvas.offsetx + xmin, canvas.offsetx + xmax, canvas.offsety + y, canvas.offsety + y);
+
+  float* zrow = z_buffer.buffer[y] + xmin;
+  Uint32* crow = canvas.frame_buffer->buffer + canvas.frame_buffer->width * (canvas.offsety + y) + canvas.offsetx + xmin;
+  uint16_t* orow = overdraw.empty() ? nullptr : overdraw.data() + (size_t)canvas.width * y + xmin;
+
+  const int cy = y >> CELL_SHIFT;
+  const int row = y & (CELL_SIZE - 1);
+  float* zmin = z_buffer.zmin + cy * z_buffer.cell_cols;
+  float* zmax = z_buffer.zmax + cy * z_buffer.cell_cols;
+  uint8_t* stale = z_buffer.stale + cy * z_buffer.cell_cols;
+  uint8_t* row_hit = z_buffer.row_hit + (cy * z_buffer.cell_cols << CELL_SHIFT);
+
+  const int n = xmax - xmin + 1;
+  ++statistic.spans;
+  statistic.span_pixels += n;
+
+  // COMMENT: A Short Span Costs About As Much To Test Per Pixel As Per Cell, So It Only Keeps zmin A Lower Bound.
+  // NOTE: Its Rows Are Not Marked As Hit, Which Leaves zmax Too Far, But Still Conservative.
+  if (n < 2 * CELL_SIZE)
   {
-    if (0 <= x0 && x0 < canvas.frame_buffer->width && 0 <= y0 && y0 < canvas.frame_buffer->height)
+    statistic.written_pixels += TestSpan(zrow, crow, orow, 0, n, z, dzdx, color);
+    const float lo = std::min(z, z + dzdx * (float)(n - 1));
+    for (int cx = xmin >> CELL_SHIFT; cx <= xmax >> CELL_SHIFT; ++cx)
     {
-      RenderPixel(*canvas.frame_buffer, x0, y0, color);
+      zmin[cx] = std::min(zmin[cx], lo);
     }
     return;
   }
 
-  if (dy == 0)
+  // COMMENT: Walk The Span Cell By Cell. Lanes [begin, end) Fall In Cell cx. Neighbouring Cells That Need Per Pixel Tests Share One Run Starting At Lane run.
+  // NOTE: Lane Depths Are All Computed As z + dzdx * k, Which Is Monotonic In k, So The Two End Lanes Bound Every Lane Of A Piece.
+  int run = 0;
+  for (int begin = 0, end; begin < n; begin = end)
   {
-    if (0 <= y0 && y0 < canvas.frame_buffer->height)
+    const int cx = (xmin + begin) >> CELL_SHIFT;
+    end = std::min(((cx + 1) << CELL_SHIFT) - xmin, n);
+
+    const float z0 = z + dzdx * (float)begin;
+    const float z1 = z + dzdx * (float)(end - 1);
+    const float lo = std::min(z0, z1);
+    const float hi = std::max(z0, z1);
+
+    ++statistic.span_cells;
+    if (lo < zmax[cx] && stale[cx] != 0)
+    {
+      RefreshCell(z_buffer, cx, cy);
+    }
+    if (lo >= zmax[cx])
     {
-      if (x0 < x1)
+      // COMMENT: Trivial Reject. Every Stored Depth Is At Least As Near As The Piece.
+      ++statistic.rejected_cells;
+      statistic.written_pixels += TestSpan(zrow, crow, orow, run, begin, z, dzdx, color);
+      run = end;
+      continue;
+    }
+    if (hi < zmin[cx])
+    {
+      // COMMENT: Trivial Accept. Every Stored Depth Is Farther Than The Piece.
+      ++statistic.accepted_cells;
+      statistic.written_pixels += TestSpan(zrow, crow, orow, run, begin, z, dzdx, color);
+      run = end;
+      for (int i = begin; i < end; ++i)
       {
-        for (int x = std::max(x0, 0); x <= std::min(x1, canvas.frame_buffer->width-1); ++x)
-        {
-          RenderPixel(*canvas.frame_buffer, x, y0, color);
-        }
+        zrow[i] = z + dzdx * (float)i;
       }
-      else
+      std::fill(crow + begin, crow + end, color);
+      statistic.written_pixels += end - begin;
+      if (orow != nullptr)
       {
-        ASSERT(x0 > x1);
-        for (int x = std::max(x1, 0); x <= std::min(x0, canvas.frame_buffer->width-1); ++x)
+        for (int i = begin; i < end; ++i)
         {
-          RenderPixel(*canvas.frame_buffer, x, y0, color);
+          ++orow[i];
         }
       }
     }
+
+    // COMMENT: Depths Left By The Piece Are No Nearer Than Its Nearest End, Which Keeps zmin A Lower Bound.
+    zmin[cx] = std::min(zmin[cx], lo);
+
+    // COMMENT: Every Tested Lane Ends Up Nearer Than bgz, Passed Or Not. Once A Whole Row Has Been Hit, Its Farthest Depth Can Drop, So It Is Marked For Refresh.
+    uint8_t& hit = row_hit[(cx << CELL_SHIFT) + row];
+    hit |= (uint8_t)(((1u << (end - begin)) - 1u) << ((xmin + begin) & (CELL_SIZE - 1)));
+    if (hit == (uint8_t)((1u << std::min(CELL_SIZE, z_buffer.width - (cx << CELL_SHIFT))) - 1u))
+    {
+      stale[cx] |= (uint8_t)(1u << row);
+    }
+  }
+  statistic.written_pixels += TestSpan(zrow, crow, orow, run, n, z, dzdx, color);
+}
+
+void Rasterizer::RenderOverdraw(const Canvas& canvas) NOEXCEPT
+{
+  if (overdraw.size() != (size_t)canvas.width * (size_t)canvas.height)
+  {
     return;
   }
-  if (dx == 0)
+
+  // COMMENT: One Color Per Count. Past Black, Hue Runs From Blue Through Green To Red.
+  Uint32 palette[OVERDRAW_SCALE + 1];
+  palette[0] = MapColor(*canvas.frame_buffer, Color(0.0f));
+  for (int k = 1; k <= OVERDRAW_SCALE; ++k)
+  {
+    const float t = 2.0f * (float)(k - 1) / (float)std::max(OVERDRAW_SCALE - 1, 1) - 1.0f;
+    palette[k] = MapColor(*canvas.frame_buffer, Color(std::max(t, 0.0f), 1.0f - std::abs(t), std::max(-t, 0.0f)));
+  }
+
+  FrameBuffer::Touch(*canvas.frame_buffer, canvas.offsetx, canvas.offsetx + canvas.width - 1, canvas.offsety, canvas.offsety + canvas.height - 1);
+  for (int y = 0; y < canvas.height; ++y)
   {
-    if (0 <= x0 && x0 < canvas.frame_buffer->width)
+    const uint16_t* orow = overdraw.data() + (size_t)canvas.width * y;
+    Uint32* crow = canvas.frame_buffer->buffer + canvas.frame_buffer->width * (canvas.offsety + y) + canvas.offsetx;
+    for (int x = 0; x < canvas.width; ++x)
     {
-      if (y0 < y1)
-      {
-        for (int y = std::max(y0, 0); y < std::min(y1, canvas.frame_buffer->height-1); ++y)
-        {
-          RenderPixel(*canvas.frame_buffer, x0, y, color);
-        }
-      }
-      else
-      {
-        ASSERT(y0 > y1);
-        for (int y = std::max(y1, 0); y < std::min(y0, canvas.frame_buffer->height-1); ++y)
-        {
-          RenderPixel(*canvas.frame_buffer, x0, y, color);
-        }
-      }
+      crow[x] = palette[std::min((int)orow[x], OVERDRAW_SCALE)];
     }
-    return;
   }
+}
+
+void Rasterizer::RenderTangentDDA(const Canvas& canvas, int x0, int y0, int x1, int y1, const Uint32& color) NOEXCEPT
+{
+  x0 += canvas.offsetx, y0 += canvas.offsety, x1 += canvas.offsetx, y1 += canvas.offsety;
 
-  int x = x0;
-  int y = y0;
+  int len = std::max(std::abs(x1 - x0), std::abs(y1 - y0));
 
-  int sx = 0;
-  int sy = 0;
+  float dx = (float)(x1 - x0) / (float)len;
+  float dy = (float)(y1 - y0) / (float)len;
   
-  if (dx > 0)
+  float x = x0, y = y0;
+
+  for (int i = 0; i < len && 0 <= x && x < canvas.frame_buffer->width && 0 <= y && y < canvas.frame_buffer->height; ++i)
   {
-    sx = 1;
+    RenderPixel(*canvas.frame_buffer, (int)x, (int)y, color);
+    x += dx, y += dy;
   }
-  else
+}
+
+void Rasterizer::RenderTangentDDA(const Canvas& canvas, const int x0, const int y0, const int x1, const int y1, const Color& color) NOEXCEPT
+{
+  RenderTangentDDA(canvas, x0, y0, x1, y1, MapColor(*canvas.frame_buffer, color));
+}
+
+NODISCARD bool Rasterizer::ClipLine(const Canvas& canvas, float& x0, float& y0, float& x1, float& y1) NOEXCEPT
+{
+  if (std::isnan(x0) || std::isnan(y0) || std::isnan(x1) || std::isnan(y1))
+  {
+    return false;
+  }
+
+  enum : int { LEFT = 1, RIGHT = 2, BOTTOM = 4, TOP = 8 };
+
+  const float xmin = 0.0f;
+  const float ymin = 0.0f;
+  const float xmax = (float)(canvas.width - 1);
+  const float ymax = (float)(canvas.height - 1);
+
+  auto Code = [&](const float x, const float y) NOEXCEPT -> int
   {
-    ASSERT(dx < 0);
-    sx = -1;
-    dx = -dx;
+    return (x < xmin ? LEFT : x > xmax ? RIGHT : 0) | (y < ymin ? BOTTOM : y > ymax ? TOP : 0);
+  };
+
+  int code0 = Code(x0, y0);
+  int code1 = Code(x1, y1);
+
+  while (true)
+  {
+    if ((code0 | code1) == 0)
+    {
+      return true;
+    }
+    if ((code0 & code1) != 0)
+    {
+      return false;
+    }
+
+    const int code = code0 != 0 ? code0 : code1;
+    float x = 0.0f, y = 0.0f;
+    if (code & TOP)
+    {
+      x = x0 + (x1 - x0) * (ymax - y0) / (y1 - y0), y = ymax;
+    }
+    else if (code & BOTTOM)
+    {
+      x = x0 + (x1 - x0) * (ymin - y0) / (y1 - y0), y = ymin;
+    }
+    else if (code & RIGHT)
+    {
+      y = y0 + (y1 - y0) * (xmax - x0) / (x1 - x0), x = xmax;
+    }
+    else
+    {
+      y = y0 + (y1 - y0) * (xmin - x0) / (x1 - x0), x = xmin;
+    }
+
+    if (code == code0)
+    {
+      x0 = x, y0 = y, code0 = Code(x0, y0);
+    }
+    else
+    {
+      x1 = x, y1 = y, code1 = Code(x1, y1);
+    }
   }
+}
+
+// COMMENT: Ceil Of a / b For b > 0.
+NODISCARD FORCE_INLINE static int64_t CeilDiv(const int64_t a, const int64_t b) NOEXCEPT
+{
+  return a >= 0 ? (a + b - 1) / b : -((-a) / b);
+}
 
-  if (dy > 0)
+void Rasterizer::RenderLine(const Canvas& canvas, const Line& line, const int ymin, const int ymax) NOEXCEPT
+{
+  // COMMENT: Walk From The Upper Endpoint, So A Line Draws The Same Pixels In Both Directions.
+  int x0 = line.x0, y0 = line.y0, x1 = line.x1, y1 = line.y1;
+  if (y0 > y1 || (y0 == y1 && x0 > x1))
   {
-    sy = 1;
+    std::swap(x0, x1);
+    std::swap(y0, y1);
   }
-  else
+
+  const int64_t adx = std::abs(x1 - x0);
+  const int64_t ady = y1 - y0;
+  const int sx = x1 >= x0 ? 1 : -1;
+
+  const int kmin = std::max(ymin - y0, 0);
+  const int kmax = std::min(ymax - y0, (int)ady);
+
+  if (ady == 0)
   {
-    ASSERT(dy < 0);
-    sy = -1;
-    dy = -dy;
+    if (kmin <= kmax)
+    {
+      RenderSegment(*canvas.frame_buffer, canvas.offsetx + x0, canvas.offsetx + x1, canvas.offsety + y0, line.color);
+    }
+    return;
   }
 
-  const int dy2 = dy << 1;
-  const int dx2 = dx << 1;
-  
-  if (dx > dy)
+  if (adx >= ady)
   {
-    int e = dy2 - dx;
-    for (int i = 0; i <= dx && 0 <= x && x < canvas.frame_buffer->width && 0 <= y && y < canvas.frame_buffer->height; ++i)
+    // COMMENT: Pixel i Sits On Row floor((2 * i * ady + adx) / (2 * adx)). Solving For i Gives The Run Of Row k.
+    for (int k = kmin; k <= kmax; ++k)
     {
-      RenderPixel(*canvas.frame_buffer, x, y, color);
-      while(e > 0)
-      {
-        y += sy;
-        e -= dx2;
-      }        
-      x += sx;
-      e += dy2;
+      const int64_t ibegin = std::max(CeilDiv((2 * k - 1) * adx, 2 * ady), (int64_t)0);
+      const int64_t iend = std::min(CeilDiv((2 * k + 1) * adx, 2 * ady) - 1, adx);
+      const int xa = x0 + sx * (int)ibegin;
+      const int xb = x0 + sx * (int)iend;
+      RenderSegment(*canvas.frame_buffer, canvas.offsetx + std::min(xa, xb), canvas.offsetx + std::max(xa, xb), canvas.offsety + y0 + k, line.color);
     }
   }
   else
   {
-    int e = dx2 - dy;
-    for (int i = 0; i <= dy && 0 <= x && x < canvas.frame_buffer->width && 0 <= y && y < canvas.frame_buffer->height; ++i)
+    for (int k = kmin; k <= kmax; ++k)
     {
-      RenderPixel(*canvas.frame_buffer, x, y, color);
-      while(e > 0)
-      {
-        x += sx;
-        e -= dy2;
-      }        
-      y += sy;
-      e += dx2;
+      const int x = x0 + sx * (int)((2 * k * adx + ady) / (2 * ady));
+      RenderPixel(*canvas.frame_buffer, canvas.offsetx + x, canvas.offsety + y0 + k, line.color);
     }
   }
 }
 
+// COMMENT: Clip, Round And Draw A Line Given In Canvas Coordinates.
+static void RenderClippedLine(const Canvas& canvas, float x0, float y0, float x1, float y1, const Uint32 color) NOEXCEPT
+{
+  if (!Rasterizer::ClipLine(canvas, x0, y0, x1, y1))
+  {
+    return;
+  }
+  const Rasterizer::Line line = {(int)std::round(x0), (int)std::round(y0), (int)std::round(x1), (int)std::round(y1), color};
+  Rasterizer::RenderLine(canvas, line, 0, canvas.height - 1);
+}
+
+void Rasterizer::RenderTangentBresenham(const Canvas& canvas, const int x0, const int y0, const int x1, const int y1, const Uint32& color) NOEXCEPT
+{
+  RenderClippedLine(canvas, (float)x0, (float)y0, (float)x1, (float)y1, color);
+}
+
 void Rasterizer::RenderTangentBresenham(const Canvas& canvas, const int x0, const int y0, const int x1, const int y1, const Color& color) NOEXCEPT
 {
   RenderTangentBresenham(canvas, x0, y0, x1, y1, MapColor(*canvas.frame_buffer, color));
@@ -209,13 +519,7 @@ void Rasterizer::RenderPolygonsWireframe(const Canvas& canvas, const std::vector
     {
       glm::vec3 v0 = vertices[polygon.vertices[0]];
       glm::vec3 v1 = vertices[polygon.vertices[1]];
-      RenderTangentBresenham(canvas,
-        (int)std::round(v0.x),
-        (int)std::round(v0.y),
-        (int)std::round(v1.x),
-        (int)std::round(v1.y),
-        polygon.color
-      );
+      RenderClippedLine(canvas, v0.x, v0.y, v1.x, v1.y, polygon.mapped_color);
       continue;
     }
     for (size_t i = 0; i < polygon.vertices.size(); ++i)
@@ -223,15 +527,90 @@ void Rasterizer::RenderPolygonsWireframe(const Canvas& canvas, const std::vector
       size_t j = (i + 1) % polygon.vertices.size();
       glm::vec3 v0 = vertices[polygon.vertices[i]];
       glm::vec3 v1 = vertices[polygon.vertices[j]];
-      RenderTangentBresenham(canvas,
-        (int)std::round(v0.x),
-        (int)std::round(v0.y),
-        (int)std::round(v1.x),
-        (int)std::round(v1.y),
-        polygon.color
-      );
+      RenderClippedLine(canvas, v0.x, v0.y, v1.x, v1.y, polygon.mapped_color);
+    }
+  }
+}
+
+void Rasterizer::RenderEdgesWireframe(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const std::vector<uint32_t>& index, const std::vector<Model::Edge>& edges, const bool parallel) NOEXCEPT
+{
+  static std::vector<Line> lines; lines.clear();
+
+  for (const auto& edge : edges)
+  {
+    // COMMENT: An Edge Is Visible While Either Of Its Polygons Survived Culling And Clipping, And Takes That Polygon's Color.
+    uint32_t pid = index[edge.p0];
+    if (pid == (uint32_t)-1 && edge.p1 != (uint32_t)-1)
+    {
+      pid = index[edge.p1];
+    }
+    if (pid == (uint32_t)-1)
+    {
+      continue;
+    }
+
+    float x0 = vertices[edge.v0].x, y0 = vertices[edge.v0].y;
+    float x1 = vertices[edge.v1].x, y1 = vertices[edge.v1].y;
+    if (ClipLine(canvas, x0, y0, x1, y1))
+    {
+      lines.push_back({(int)std::round(x0), (int)std::round(y0), (int)std::round(x1), (int)std::round(y1), polygons[pid].mapped_color});
+    }
+  }
+
+  if (!parallel)
+  {
+    for (const auto& line : lines)
+    {
+      RenderLine(canvas, line, 0, canvas.height - 1);
+    }
+    return;
+  }
+
+  static std::vector<int> starts;
+  TileRowBands(canvas, starts);
+  const int bands = (int)starts.size() - 1;
+
+  // COMMENT: Bin Lines Into Every Band Their Rows Reach.
+  static std::vector<uint32_t> offsets; offsets.assign(bands + 1, 0);
+  static std::vector<uint32_t> binned;  binned.clear();
+  static std::vector<uint32_t> cursor;
+
+  auto Bands = [&](const Line& line, auto&& visit) NOEXCEPT -> void
+  {
+    const int ymin = std::min(line.y0, line.y1);
+    const int ymax = std::max(line.y0, line.y1);
+    const int first = (int)(std::upper_bound(starts.begin(), starts.end() - 1, ymin) - starts.begin()) - 1;
+    for (int band = first; band < bands && starts[band] <= ymax; ++band)
+    {
+      visit(band);
     }
+  };
+
+  for (const auto& line : lines)
+  {
+    Bands(line, [&](const int band) NOEXCEPT { ++offsets[band + 1]; });
+  }
+  for (int band = 0; band < bands; ++band)
+  {
+    offsets[band + 1] += offsets[band];
+  }
+  binned.resize(offsets[bands]);
+  cursor.assign(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    Bands(lines[i], [&](const int band) NOEXCEPT { binned[cursor[band]++] = (uint32_t)i; });
   }
+
+  const ThreadPool::Task task = [&](const int band, const int thread) NOEXCEPT
+  {
+    (void)thread;
+    PROFILE_SCOPE(Profiler::RASTERIZE);
+    for (uint32_t i = offsets[band]; i < offsets[band + 1]; ++i)
+    {
+      RenderLine(canvas, lines[binned[i]], starts[band], starts[band + 1] - 1);
+    }
+  };
+  ThreadPool::ParallelFor(bands, task);
 }
 
 void Rasterizer::RenderPolygonsScanConvertZBuffer(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT
@@ -256,12 +635,6 @@ void Rasterizer::RenderPolygonsScanConvertZBuffer(const Canvas& canvas, const st
     C[pid] = glm::dot(n, p0) / n.z;
   }
 
-  auto TestZ = [&](const uint32_t pid, const int x, const int y) NOEXCEPT -> float
-  {
-    if (pid == polygons.size()) { return canvas.z_buffer->bgz; }
-    return A[pid] * x + B[pid] * y + C[pid];
-  };
-
   std::vector<Edge> ET; ET.clear();
   ET.reserve(std::accumulate(polygons.begin(), polygons.end(), 0, [](const size_t acc, const Polygon& polygon) { return std::max(acc, polygon.vertices.size()); }));
 
@@ -269,7 +642,10 @@ void Rasterizer::RenderPolygonsScanConvertZBuffer(const Canvas& canvas, const st
   {
     if (polygons[pid].vertices.size() < 3) { continue; }
    
+    ++statistic.rasterized_polygons;
     ET.clear();
+
+    const Uint32 color = polygons[pid].mapped_color;
    
     glm::ivec2 vmin = glm::ivec2(canvas.height-1, canvas.width-1);      
     glm::ivec2 vmax = glm::ivec2(0, 0); 
@@ -378,15 +754,9 @@ void Rasterizer::RenderPolygonsScanConvertZBuffer(const Canvas& canvas, const st
           continue;
         }
 
-        for (int x = std::max(vmin.x, (*it)->x); x <= std::min(vmax.x, (*nxt)->x); ++x)
-        {
-          float curz = TestZ(pid, x, y);
-          if (canvas.z_buffer->buffer[y][x] > curz)
-          {
-            canvas.z_buffer->buffer[y][x] = curz;
-            RenderPixel(*canvas.frame_buffer, x, y, polygons[pid].color);
-          }
-        }
+        const int xmin = std::max(vmin.x, (*it)->x);
+        const int xmax = std::min(vmax.x, (*nxt)->x);
+        RenderSpan(canvas, xmin, xmax, y, A[pid] * xmin + B[pid] * y + C[pid], A[pid], color);
       }
    
       for (auto& edge : AET)
@@ -425,12 +795,6 @@ void Rasterizer::RenderPolygonsScanConvertHZBuffer(Canvas& canvas, const std::ve
     C[pid] = glm::dot(n, p0) / n.z;
   }
 
-  auto TestZ = [&](const uint32_t pid, const int x, const int y) NOEXCEPT -> float
-  {
-    if (pid == polygons.size()) { return canvas.z_buffer->bgz; }
-    return A[pid] * x + B[pid] * y + C[pid];
-  };
-   
   std::vector<Edge> ET; ET.clear();
   ET.reserve(std::accumulate(polygons.begin(), polygons.end(), 0, [](const size_t acc, const Polygon& polygon) { return std::max(acc, polygon.vertices.size()); }));
 
@@ -439,6 +803,8 @@ void Rasterizer::RenderPolygonsScanConvertHZBuffer(Canvas& canvas, const std::ve
     if (polygons[pid].vertices.size() < 3) { continue; }
      
     ET.clear();
+
+    const Uint32 color = polygons[pid].mapped_color;
      
     glm::ivec2 vmin = glm::ivec2(canvas.height-1, canvas.width-1);      
     glm::ivec2 vmax = glm::ivec2(0, 0); 
@@ -500,14 +866,12 @@ void Rasterizer::RenderPolygonsScanConvertHZBuffer(Canvas& canvas, const std::ve
     vmin = glm::max(vmin, glm::ivec2(0, 0));
     vmax = glm::min(vmax, glm::ivec2(canvas.width-1, canvas.height-1));
 
-    if (ZBH::Query(canvas.zbh_tree, vmin.x, vmax.x, vmin.y, vmax.y) <= AABB::From(vertices, polygons[pid]).vmin.z)
+    if (HZBuffer::Query(*canvas.h_z_buffer, vmin.x, vmax.x, vmin.y, vmax.y) <= AABB::From(vertices, polygons[pid]).vmin.z)
     {
-        continue;
+      ++statistic.occluded_polygons;
+      continue;
     }
-      // if (HZBuffer::Query(canvas.h_z_buffer, vmin.x, vmax.x, vmin.y, vmax.y) <= AABB::From(vertices, polygons[pid]).vmin.z)
-    // {
-    //   continue;;
-    // }
+    ++statistic.rasterized_polygons;
 
     std::sort(ET.begin(), ET.end());
 
@@ -556,15 +920,9 @@ void Rasterizer::RenderPolygonsScanConvertHZBuffer(Canvas& canvas, const std::ve
           continue;
         }
 
-        for (int x = std::max(vmin.x, (*it)->x); x <= std::min(vmax.x, (*nxt)->x); ++x)
-        {
-          float curz = TestZ(pid, x, y);
-          if (canvas.z_buffer->buffer[y][x] > curz)
-          {
-            canvas.z_buffer->buffer[y][x] = curz;
-            RenderPixel(*canvas.frame_buffer, canvas.offsetx + x, canvas.offsety + y, polygons[pid].color);
-          }
-        }
+        const int xmin = std::max(vmin.x, (*it)->x);
+        const int xmax = std::min(vmax.x, (*nxt)->x);
+        RenderSpan(canvas, xmin, xmax, y, A[pid] * xmin + B[pid] * y + C[pid], A[pid], color);
       }
       
       for (auto& edge : AET)
@@ -579,393 +937,588 @@ void Rasterizer::RenderPolygonsScanConvertHZBuffer(Canvas& canvas, const std::ve
       }
     }
 
-    ZBH::Update(canvas.zbh_tree, canvas, vmin.x, vmax.x, vmin.y, vmax.y);
+    PROFILE_SCOPE(Profiler::Z_PYRAMID);
+    HZBuffer::Update(*canvas.h_z_buffer, vmin.x, vmax.x, vmin.y, vmax.y);
 
   }
 }
 
-void Rasterizer::RenderPolygonsScanConvertHAABBHZBuffer(Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const std::vector<HAABB>& haabbs) NOEXCEPT
+// COMMENT: Scan Convert Polygon pid, Whose Depth Is a * x + b * y + c, Inside Its Canvas Bounds [bmin, bmax] And Report Them To The Z Pyramid.
+static void RenderPolygonHZBuffer(Canvas& canvas, const std::vector<Vertex>& vertices, const Polygon& polygon, const size_t pid, const glm::vec2& bmin, const glm::vec2& bmax, const float a, const float b, const float c, std::vector<Rasterizer::Edge>& ET) NOEXCEPT
 {
-  std::vector<float> A; A.clear();
-  std::vector<float> B; B.clear();
-  std::vector<float> C; C.clear();
-   
-  A.resize(polygons.size());
-  B.resize(polygons.size());
-  C.resize(polygons.size());
+  using Edge = Rasterizer::Edge;
+
+  ++Rasterizer::statistic.rasterized_polygons;
+  ET.clear();
+
+  const Uint32 color = polygon.mapped_color;
    
-  for (size_t pid = 0; pid < polygons.size(); ++pid)
+  for (size_t i = 0; i < polygon.vertices.size(); ++i)
   {
-    if (polygons[pid].vertices.size() < 3) { continue; }
-    glm::vec3 p0 = vertices[polygons[pid].vertices[0]];
-    glm::vec3 p1 = vertices[polygons[pid].vertices[1]];
-    glm::vec3 p2 = vertices[polygons[pid].vertices[2]];
-    glm::vec3 n = glm::normalize(glm::cross(p0 - p1, p1 - p2));
-    A[pid] = -n.x / n.z;
-    B[pid] = -n.y / n.z;
-    C[pid] = glm::dot(n, p0) / n.z;
-  }
+    size_t j = (i + 1) % polygon.vertices.size();
 
-  auto TestZ = [&](const uint32_t pid, const int x, const int y) NOEXCEPT -> float
-  {
-    if (pid == polygons.size()) { return canvas.z_buffer->bgz; }
-    return A[pid] * x + B[pid] * y + C[pid];
-  };
+    glm::vec3 v0 = vertices[polygon.vertices[i]];
+    glm::vec3 v1 = vertices[polygon.vertices[j]];
 
-  std::vector<Edge> ET; ET.clear();
-  ET.reserve(std::accumulate(polygons.begin(), polygons.end(), 0, [](const size_t acc, const Polygon& polygon) { return std::max(acc, polygon.vertices.size()); }));
-  
-  std::stack<int> stk;
-  stk.push(1);
-  while(!stk.empty())
-  {
-    int cur = stk.top();
-    stk.pop();
-    float z = ZBH::Query(canvas.zbh_tree, haabbs[cur].vmin.x, haabbs[cur].vmax.x, haabbs[cur].vmin.y, haabbs[cur].vmax.y);
-    if (z <= haabbs[cur].vmin.z)
+    if (std::round(v0.y) == std::round(v1.y))
     {
       continue;
     }
-    if (haabbs[cur].l != 0)
-    {
-      stk.push(haabbs[cur].l);
-    }
-    if (haabbs[cur].r != 0)
+     
+    if (v0.y > v1.y)
     {
-      stk.push(haabbs[cur].r);
+      std::swap(v0, v1);
     }
-    if (haabbs[cur].pid != polygons.size())
+
+    float dxdy = (std::round(v0.x) - std::round(v1.x)) / (std::round(v0.y) - std::round(v1.y));
+     
+    Edge edge {
+      .ymin = (int)std::round(v0.y),
+      .ymax = (int)std::round(v1.y),
+      .x = (int)std::round(v0.x),
+      .d = dxdy > 0.0f ? 1 : -1,
+      .m = std::abs(dxdy),
+      .e = std::abs(dxdy) - 0.5f,
+      .pid = pid,
+    };
+
+    if (edge.ymax >= 0 && edge.ymin < canvas.height)
     {
-      int pid = haabbs[cur].pid;
-      if (polygons[pid].vertices.size() < 3)
+      if (edge.ymin < 0)
       {
-        continue;
-      }
-      ET.clear();
-       
-      for (size_t i = 0; i < polygons[pid].vertices.size(); ++i)
-      {
-        size_t j = (i + 1) % polygons[pid].vertices.size();
-
-        glm::vec3 v0 = vertices[polygons[pid].vertices[i]];
-        glm::vec3 v1 = vertices[polygons[pid].vertices[j]];
-
-        if (std::round(v0.y) == std::round(v1.y))
-        {
-          continue;
-        }
-         
-        if (v0.y > v1.y)
+        edge.e += edge.m * (0 - edge.ymin);
+        while(edge.e > 0.0f)
         {
-          std::swap(v0, v1);
+          edge.x += edge.d;
+          edge.e -= 1.0f;
         }
+        edge.ymin = 0;
+      }
 
-        float dxdy = (std::round(v0.x) - std::round(v1.x)) / (std::round(v0.y) - std::round(v1.y));
-         
-        Edge edge {
-          .ymin = (int)std::round(v0.y),
-          .ymax = (int)std::round(v1.y),
-          .x = (int)std::round(v0.x),
-          .d = dxdy > 0.0f ? 1 : -1,
-          .m = std::abs(dxdy),
-          .e = std::abs(dxdy) - 0.5f,
-          .pid = (size_t)pid,
-        };
-
-        if (edge.ymax >= 0 && edge.ymin < canvas.height)
-        {
-          if (edge.ymin < 0)
-          {
-            edge.e += edge.m * (0 - edge.ymin);
-            while(edge.e > 0.0f)
-            {
-              edge.x += edge.d;
-              edge.e -= 1.0f;
-            }
-            edge.ymin = 0;
-          }
-
-          if(edge.ymax >= canvas.height)
-          {
-            edge.ymax = canvas.height-1;
-          }
-
-          ET.emplace_back(edge);
-        }
+      if(edge.ymax >= canvas.height)
+      {
+        edge.ymax = canvas.height-1;
       }
 
-      glm::ivec2 vmin = glm::max(glm::ivec2(glm::round(haabbs[cur].vmin)), glm::ivec2(0, 0));
-      glm::ivec2 vmax = glm::min(glm::ivec2(glm::round(haabbs[cur].vmax)), glm::ivec2(canvas.width-1, canvas.height-1));
-       
-      std::sort(ET.begin(), ET.end());
+      ET.emplace_back(edge);
+    }
+  }
 
-      std::list<Edge*> AET;
-       
-      for (int y = vmin.y, j = 0; y <= vmax.y; ++y)
+  glm::ivec2 vmin = glm::max(glm::ivec2(glm::round(bmin)), glm::ivec2(0, 0));
+  glm::ivec2 vmax = glm::min(glm::ivec2(glm::round(bmax)), glm::ivec2(canvas.width-1, canvas.height-1));
+   
+  std::sort(ET.begin(), ET.end());
+
+  std::list<Edge*> AET;
+   
+  for (int y = vmin.y, j = 0; y <= vmax.y; ++y)
+  {
+    while((size_t)j < ET.size() && ET[j].ymin < y)
+    {
+      ++j;
+    }
+    {
+      auto it = AET.begin();
+      while ((size_t)j < ET.size() && ET[j].ymin == y)
       {
-        while((size_t)j < ET.size() && ET[j].ymin < y)
+        while(it != AET.end() && (*it)->x <= ET[j].x)
         {
-          ++j;
+          ++it;
         }
+        while(it != AET.end() && (*it)->x == ET[j].x && (*it)->d * (*it)->m <= ET[j].d * ET[j].m)
         {
-          auto it = AET.begin();
-          while ((size_t)j < ET.size() && ET[j].ymin == y)
-          {
-            while(it != AET.end() && (*it)->x <= ET[j].x)
-            {
-              ++it;
-            }
-            while(it != AET.end() && (*it)->x == ET[j].x && (*it)->d * (*it)->m <= ET[j].d * ET[j].m)
-            {
-              ++it;
-            }
-            it = AET.emplace(it, &ET[j++]);
-          }
+          ++it;
         }
+        it = AET.emplace(it, &ET[j++]);
+      }
+    }
 
-        for (auto it = AET.begin(); it != AET.end();)
-        {
-          if ((*it)->ymin == (*it)->ymax)
-          {
-            it = AET.erase(it);
-          }
-          else
-          {
-            ++it;
-          }
-        }
+    for (auto it = AET.begin(); it != AET.end();)
+    {
+      if ((*it)->ymin == (*it)->ymax)
+      {
+        it = AET.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
 
-        for (auto it = AET.begin(); it != std::prev(AET.end()); ++it)
-        {
-          auto nxt = std::next(it);
+    for (auto it = AET.begin(); it != std::prev(AET.end()); ++it)
+    {
+      auto nxt = std::next(it);
 
-          if ((*it)->x == (*nxt)->x)
-          {
-            continue;
-          }
+      if ((*it)->x == (*nxt)->x)
+      {
+        continue;
+      }
 
-          for (int x = std::max(vmin.x, (*it)->x); x <= std::min(vmax.x, (*nxt)->x); ++x)
-          {
-            float curz = TestZ(pid, x, y);
-            if (canvas.z_buffer->buffer[y][x] > curz)
-            {
-              canvas.z_buffer->buffer[y][x] = curz;
-              RenderPixel(*canvas.frame_buffer, canvas.offsetx + x, canvas.offsety + y, polygons[pid].color);
-            }
-          }
-        }
-        for (auto& edge : AET)
-        {
-          edge->ymin += 1;
-          edge->e += edge->m;
-          while(edge->e > 0.0f)
-          {
-            edge->x += edge->d;
-            edge->e -= 1.0f;
-          }
-        }
+      const int xmin = std::max(vmin.x, (*it)->x);
+      const int xmax = std::min(vmax.x, (*nxt)->x);
+      Rasterizer::RenderSpan(canvas, xmin, xmax, y, a * xmin + b * y + c, a, color);
+    }
+    for (auto& edge : AET)
+    {
+      edge->ymin += 1;
+      edge->e += edge->m;
+      while(edge->e > 0.0f)
+      {
+        edge->x += edge->d;
+        edge->e -= 1.0f;
       }
-      
-      ZBH::Update(canvas.zbh_tree, canvas, vmin.x, vmax.x, vmin.y, vmax.y);
     }
   }
+  
+  PROFILE_SCOPE(Profiler::Z_PYRAMID);
+  HZBuffer::Update(*canvas.h_z_buffer, vmin.x, vmax.x, vmin.y, vmax.y);
 }
 
-void Rasterizer::RenderPolygonsIntervalScanLine(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT
+void Rasterizer::RenderPolygonsScanConvertHAABBHZBuffer(Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const std::vector<HAABB>& haabbs) NOEXCEPT
 {
+  // NOTE: No Polygons Leaves No Root.
+  if (haabbs.size() < 2)
+  {
+    return;
+  }
+
   std::vector<float> A; A.clear();
   std::vector<float> B; B.clear();
   std::vector<float> C; C.clear();
-     
+   
   A.resize(polygons.size());
   B.resize(polygons.size());
   C.resize(polygons.size());
-     
+   
   for (size_t pid = 0; pid < polygons.size(); ++pid)
   {
     if (polygons[pid].vertices.size() < 3) { continue; }
-    glm::vec3 p0 = vertices[polygons[pid].vertices[0]]; 
-    glm::vec3 p1 = vertices[polygons[pid].vertices[1]]; 
-    glm::vec3 p2 = vertices[polygons[pid].vertices[2]]; 
+    glm::vec3 p0 = vertices[polygons[pid].vertices[0]];
+    glm::vec3 p1 = vertices[polygons[pid].vertices[1]];
+    glm::vec3 p2 = vertices[polygons[pid].vertices[2]];
     glm::vec3 n = glm::normalize(glm::cross(p0 - p1, p1 - p2));
     A[pid] = -n.x / n.z;
     B[pid] = -n.y / n.z;
     C[pid] = glm::dot(n, p0) / n.z;
   }
 
-  auto TestZ = [&](const uint32_t pid, const int x, const int y) NOEXCEPT -> float
+  std::vector<Edge> ET; ET.clear();
+  ET.reserve(std::accumulate(polygons.begin(), polygons.end(), 0, [](const size_t acc, const Polygon& polygon) { return std::max(acc, polygon.vertices.size()); }));
+  
+  std::stack<int> stk;
+  stk.push(1);
+  while(!stk.empty())
   {
-    if (pid == polygons.size()) { return canvas.z_buffer->bgz; }
-    return A[pid] * x + B[pid] * y + C[pid];
-  };
+    int cur = stk.top();
+    stk.pop();
+    ++statistic.haabb_nodes;
+    float z = HZBuffer::Query(*canvas.h_z_buffer, (int)std::floor(haabbs[cur].vmin.x), (int)std::ceil(haabbs[cur].vmax.x), (int)std::floor(haabbs[cur].vmin.y), (int)std::ceil(haabbs[cur].vmax.y));
+    if (z <= haabbs[cur].vmin.z)
+    {
+      ++statistic.haabb_culled;
+      continue;
+    }
+    if (haabbs[cur].l != 0)
+    {
+      stk.push(haabbs[cur].l);
+    }
+    if (haabbs[cur].r != 0)
+    {
+      stk.push(haabbs[cur].r);
+    }
+    if (haabbs[cur].pid != polygons.size())
+    {
+      int pid = haabbs[cur].pid;
+      if (polygons[pid].vertices.size() < 3)
+      {
+        continue;
+      }
+      RenderPolygonHZBuffer(canvas, vertices, polygons[pid], pid, glm::vec2(haabbs[cur].vmin), glm::vec2(haabbs[cur].vmax), A[pid], B[pid], C[pid], ET);
+    }
+  }
+}
 
-  glm::ivec2 vmin = glm::ivec2(canvas.height-1, canvas.width-1);      
-  glm::ivec2 vmax = glm::ivec2(0, 0);
-     
-  for (const auto& vertex : vertices)
+void Rasterizer::RenderPolygonsScanConvertBVHHZBuffer(Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const BVH& bvh, const std::vector<uint32_t>& index, const glm::mat4& MVP, const bool clip, std::vector<glm::ivec4>& rects, std::vector<uint8_t>* visible) NOEXCEPT
+{
+  // COMMENT: Node Waiting On The Stack, Already Projected. It Is Tested Against The Z Pyramid Only When Popped, After Everything Nearer Has Been Drawn.
+  struct Entry
   {
-    vmin = glm::min(vmin, glm::ivec2(glm::round(vertex)));
-    vmax = glm::max(vmax, glm::ivec2(glm::round(vertex)));
-  }
+    uint32_t id;
+    float znear;
+    glm::ivec4 rect;
+  };
 
-  vmin = glm::max(vmin, glm::ivec2(0, 0));
-  vmax = glm::min(vmax, glm::ivec2(canvas.width-1, canvas.height-1));
-     
-  std::vector<Edge> ET; ET.clear();
-  ET.reserve(2 + std::accumulate(polygons.begin(), polygons.end(), 0, [](const size_t acc, const Polygon& polygon) { return acc + polygon.vertices.size(); }));
+  static std::vector<Entry>   stack; stack.clear();
+  static std::vector<Edge>    ET;    ET.clear();
+  static std::vector<uint8_t> drawn; drawn.clear();
 
-  ET.emplace_back(vmin.y, vmax.y, vmin.x, 0, 0.0f, -0.5f, polygons.size());
-  ET.emplace_back(vmin.y, vmax.y, vmax.x, 0, 0.0f, -0.5f, polygons.size());
-     
-  for (size_t pid = 0; pid < polygons.size(); ++pid)
+  if (bvh.nodes.empty())
   {
-    if (polygons[pid].vertices.size() < 3) { continue; }
-    for (size_t i = 0; i < polygons[pid].vertices.size(); ++i)
-    {
-      size_t j = (i + 1) % polygons[pid].vertices.size();
+    return;
+  }
 
-      glm::vec3 v0 = vertices[polygons[pid].vertices[i]];
-      glm::vec3 v1 = vertices[polygons[pid].vertices[j]];
+  const auto project = [&](const uint32_t id, Entry& entry) NOEXCEPT -> bool {
+    const BVH::Node& node = bvh.nodes[id];
+    entry.id = id;
+    return Transformer::ProjectAABB(canvas, MVP, AABB{ node.vmin, node.vmax }, clip, entry.rect, entry.znear);
+  };
 
-      if (std::round(v0.y) == std::round(v1.y))
+  const auto draw = [&](const Entry& entry) NOEXCEPT -> void {
+    const BVH::Node& node = bvh.nodes[entry.id];
+    rects.emplace_back(entry.rect);
+    for (uint32_t k = node.index; k < node.index + node.count; ++k)
+    {
+      // NOTE: Polygons Removed By Culling Or Clipping Have No Slot.
+      const uint32_t pid = index[bvh.items[k]];
+      if (pid == (uint32_t)-1 || polygons[pid].vertices.size() < 3)
       {
         continue;
       }
-         
-      if (v0.y > v1.y)
+      const Polygon& polygon = polygons[pid];
+      const AABB aabb = AABB::From(vertices, polygon);
+      glm::vec3 p0 = vertices[polygon.vertices[0]];
+      glm::vec3 p1 = vertices[polygon.vertices[1]];
+      glm::vec3 p2 = vertices[polygon.vertices[2]];
+      glm::vec3 n = glm::normalize(glm::cross(p0 - p1, p1 - p2));
+      RenderPolygonHZBuffer(canvas, vertices, polygon, pid, glm::vec2(aabb.vmin), glm::vec2(aabb.vmax), -n.x / n.z, -n.y / n.z, glm::dot(n, p0) / n.z, ET);
+    }
+  };
+
+  // COMMENT: Phase One. Leaves Visible Last Frame Are Drawn Without Asking The Z Pyramid, So It Already Holds Most Occluders When The Walk Starts.
+  // NOTE: The Walk Then Marks Exactly The Leaves That Pass This Frame, And Skips Drawing Those Drawn Here.
+  if (visible != nullptr)
+  {
+    visible->resize(bvh.nodes.size(), 0);
+    drawn.assign(bvh.nodes.size(), 0);
+    for (uint32_t id = 0; id < (uint32_t)bvh.nodes.size(); ++id)
+    {
+      Entry entry;
+      if ((*visible)[id] != 0 && project(id, entry))
       {
-        std::swap(v0, v1);
+        drawn[id] = 1;
+        draw(entry);
       }
+      (*visible)[id] = 0;
+    }
+  }
 
-      float dxdy = (std::round(v0.x) - std::round(v1.x)) / (std::round(v0.y) - std::round(v1.y));
-         
-      Edge edge {
-        .ymin = (int)std::round(v0.y),
-        .ymax = (int)std::round(v1.y),
-        .x = (int)std::round(v0.x),
-        .d = dxdy > 0.0f ? 1 : -1,
-        .m = std::abs(dxdy),
-        .e = std::abs(dxdy) - 0.5f,
-        .pid = pid,
-      };
+  Entry root;
+  if (project(0, root))
+  {
+    stack.emplace_back(root);
+  }
 
-      if (edge.ymax >= vmin.y && edge.ymin <= vmax.y)
-      {
-        if (edge.ymin < vmin.y)
-        {
-          edge.e += edge.m * (vmin.y - edge.ymin);
-          while(edge.e > 0.0f)
-          {
-            edge.x += edge.d;
-            edge.e -= 1.0f;
-          }
-          edge.ymin = vmin.y;
-        }
+  while (!stack.empty())
+  {
+    const Entry entry = stack.back();
+    stack.pop_back();
 
-        if(edge.ymax > vmax.y)
-        {
-          edge.ymax = vmax.y;
-        }
+    ++statistic.haabb_nodes;
+    if (HZBuffer::Query(*canvas.h_z_buffer, entry.rect.x, entry.rect.y, entry.rect.z, entry.rect.w) <= entry.znear)
+    {
+      ++statistic.haabb_culled;
+      continue;
+    }
 
-        ET.emplace_back(edge);
+    const BVH::Node& node = bvh.nodes[entry.id];
+    if (node.count == 0)
+    {
+      // COMMENT: Children Off Screen Are Dropped Here. Of The Rest, The Nearer Is Pushed Last So It Is Drawn First.
+      Entry l, r;
+      const bool lv = project(entry.id + 1, l);
+      const bool rv = project(node.index, r);
+      if (lv && rv && l.znear > r.znear)
+      {
+        std::swap(l, r);
+      }
+      if (rv) { stack.emplace_back(r); }
+      if (lv) { stack.emplace_back(l); }
+      continue;
+    }
+
+    // COMMENT: Phase Two. A Leaf That Passes Is Visible Next Frame.
+    if (visible != nullptr)
+    {
+      (*visible)[entry.id] = 1;
+      if (drawn[entry.id] != 0)
+      {
+        continue;
       }
     }
+    draw(entry);
   }
+}
 
-  std::sort(ET.begin(), ET.end());
+// COMMENT: Resolve Rows [ymin, ymax) Of The Interval Scan Line. spanning Holds The Edges Already Active On Row ymin.
+static void RenderRowsIntervalScanLine(const Canvas& canvas, const std::vector<Polygon>& polygons, const Rasterizer::ScanLineTable& table, const int ymin, const int ymax, const uint32_t* spanning_begin, const uint32_t* spanning_end, Rasterizer::ScanLineScratch& scratch) NOEXCEPT
+{
+  using ScanEdge = Rasterizer::ScanEdge;
 
-  std::list<Edge*> AET; AET.clear();
-  std::unordered_set<uint32_t> APT; APT.clear();
+  auto& AET  = scratch.AET;  AET.clear();
+  auto& APT  = scratch.APT;  APT.clear();
+  auto& slot = scratch.slot;
 
-  for (int y = std::max(vmin.y, 0), j = 0; y < std::min(vmax.y, canvas.height-1); ++y)
+  if (slot.size() < polygons.size())
   {
-    while((size_t)j < ET.size() && ET[j].ymin < y)
+    slot.resize(polygons.size(), -1);
+  }
+
+  auto Toggle = [&](const uint32_t pid, const int y) NOEXCEPT -> void
+  {
+    if (slot[pid] < 0)
     {
-      ++j;
+      slot[pid] = (int32_t)APT.size();
+      APT.push_back({table.A[pid], table.B[pid] * y + table.C[pid], pid});
     }
+    else
     {
-      auto it = AET.begin();
-      while ((size_t)j < ET.size() && ET[j].ymin == y)
-      {
-        while(it != AET.end() && (*it)->x <= ET[j].x)
-        {
-          ++it;
-        }
-        while(it != AET.end() && (*it)->x == ET[j].x && (*it)->d * (*it)->m <= ET[j].d * ET[j].m)
-        {
-          ++it;
-        }
-        it = AET.emplace(it, &ET[j++]);
-      }
+      const int32_t i = slot[pid];
+      APT[i] = APT.back();
+      slot[APT[i].pid] = i;
+      APT.pop_back();
+      slot[pid] = -1;
     }
+  };
 
-    for (auto it = AET.begin(); it != AET.end();)
+  auto ByX = [](const ScanEdge& lhs, const ScanEdge& rhs) NOEXCEPT -> bool { return lhs.x < rhs.x; };
+
+  // COMMENT: Seed The AET Directly From The Edge Table Instead Of Stepping Down From Row 0.
+  for (const uint32_t* it = spanning_begin; it != spanning_end; ++it)
+  {
+    ScanEdge edge = table.ET[*it];
+    edge.x = edge.xstart + (float)(ymin - edge.ystart) * edge.dxdy;
+    AET.push_back(edge);
+  }
+  std::sort(AET.begin(), AET.end(), ByX);
+
+  for (int y = ymin; y < ymax; ++y)
+  {
+    // COMMENT: Retire Finished Edges And Restore x Order In One Pass. Order Changes Only Where Edges Cross, So Insertion Sort Stays Nearly Linear.
+    size_t count = 0;
+    for (size_t i = 0; i < AET.size(); ++i)
     {
-      if ((*it)->ymin == (*it)->ymax)
+      ScanEdge edge = AET[i];
+      if (edge.yend <= y)
       {
-        it = AET.erase(it);
+        continue;
       }
-      else
+      edge.x = edge.xstart + (float)(y - edge.ystart) * edge.dxdy;
+      size_t j = count++;
+      while (j > 0 && AET[j - 1].x > edge.x)
       {
-        ++it;
+        AET[j] = AET[j - 1];
+        --j;
       }
+      AET[j] = edge;
     }
+    AET.resize(count);
 
-    // TODO: Very Slow.
-    AET.sort([](const Edge* lhs, const Edge* rhs) NOEXCEPT { return *lhs < *rhs; });
-    APT.clear();
+    // COMMENT: Edges Entering On This Row Are Sorted Among Themselves, Then Merged In Linear Time.
+    const size_t mid = AET.size();
+    AET.insert(AET.end(), table.ET.begin() + table.bucket[y], table.ET.begin() + table.bucket[y + 1]);
+    std::sort(AET.begin() + mid, AET.end(), ByX);
+    std::inplace_merge(AET.begin(), AET.begin() + mid, AET.end(), ByX);
 
-    for (auto it = AET.begin(); it != std::prev(AET.end()); ++it)
+    for (size_t i = 0; i + 1 < AET.size(); ++i)
     {
-      if (auto found = APT.find((*it)->pid); found != APT.end())
+      Toggle(AET[i].pid, y);
+
+      if (APT.empty())
       {
-        APT.erase(found);
+        continue;
       }
-      else
+
+      // COMMENT: Pixel x Lies In The Interval When xl <= x < xr.
+      const int x0 = (int)std::ceil(std::max(AET[i].x, 0.0f));
+      const int x1 = (int)std::ceil(std::min(AET[i + 1].x, (float)canvas.width)) - 1;
+
+      // COMMENT: Resolve The Nearest Polygon, Then Split Where Another Polygon Penetrates It.
+      for (int x = x0; x <= x1;)
       {
-        APT.insert((*it)->pid);
+        size_t best = 0;
+        float z = APT[0].a * x + APT[0].b;
+        for (size_t k = 1; k < APT.size(); ++k)
+        {
+          const float curz = APT[k].a * x + APT[k].b;
+          if (curz < z || (curz == z && APT[k].a < APT[best].a))
+          {
+            best = k;
+            z = curz;
+          }
+        }
+
+        int next = x1 + 1;
+        for (size_t k = 0; k < APT.size(); ++k)
+        {
+          const float slope = APT[best].a - APT[k].a;
+          if (k == best || slope <= 0.0f)
+          {
+            continue;
+          }
+          const float steps = (APT[k].a * x + APT[k].b - z) / slope;
+          if (steps < (float)(next - x))
+          {
+            next = x + (int)steps + 1;
+          }
+        }
+
+        Rasterizer::RenderSegment(*canvas.frame_buffer, canvas.offsetx + x, canvas.offsetx + next - 1, canvas.offsety + y, polygons[APT[best].pid].mapped_color);
+        x = next;
       }
+    }
 
-      auto nxt = std::next(it);
+    for (const auto& active : APT)
+    {
+      slot[active.pid] = -1;
+    }
+    APT.clear();
+  }
+}
+
+void Rasterizer::RenderPolygonsIntervalScanLine(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const bool parallel) NOEXCEPT
+{
+  static ScanLineTable                table;
+  static std::vector<ScanEdge>        edges;    edges.clear();
+  static std::vector<ScanLineScratch> scratches;
+  static std::vector<uint32_t>        cursor;
+
+  auto& A      = table.A;      A.clear();
+  auto& B      = table.B;      B.clear();
+  auto& C      = table.C;      C.clear();
+  auto& ET     = table.ET;     ET.clear();
+  auto& bucket = table.bucket; bucket.clear();
 
-      if ((*it)->x >= (*nxt)->x)
+  A.resize(polygons.size());
+  B.resize(polygons.size());
+  C.resize(polygons.size());
+  edges.reserve(std::accumulate(polygons.begin(), polygons.end(), (size_t)0, [](const size_t acc, const Polygon& polygon) { return acc + polygon.vertices.size(); }));
+
+  // COMMENT: Build The Edge Table. A Row y Is Covered When ceil(ytop) <= y < ceil(ybottom).
+  for (size_t pid = 0; pid < polygons.size(); ++pid)
+  {
+    const auto& indices = polygons[pid].vertices;
+    if (indices.size() < 3) { continue; }
+
+    // COMMENT: A Polygon Is Only Ever Active Between Its Own Edges, So One Whose Bounds Hold No Pixel Center Decides No Pixel And Is Left Out.
+    // NOTE: Dense Models Far From The Camera Are Mostly Such Polygons, And Leaving Them Out Also Keeps Their Edges Out Of Every AET.
+    glm::vec2 vmin = vertices[indices[0]].xy();
+    glm::vec2 vmax = vmin;
+    for (size_t i = 1; i < indices.size(); ++i)
+    {
+      vmin = glm::min(vmin, vertices[indices[i]].xy());
+      vmax = glm::max(vmax, vertices[indices[i]].xy());
+    }
+    vmin = glm::clamp(vmin, glm::vec2(0.0f), glm::vec2((float)canvas.width, (float)canvas.height));
+    vmax = glm::clamp(vmax, glm::vec2(0.0f), glm::vec2((float)canvas.width, (float)canvas.height));
+    if (!(std::ceil(vmin.x) < std::ceil(vmax.x) && std::ceil(vmin.y) < std::ceil(vmax.y))) { continue; }
+
+    const glm::vec3 p0 = vertices[indices[0]];
+    const glm::vec3 p1 = vertices[indices[1]];
+    const glm::vec3 p2 = vertices[indices[2]];
+    // NOTE: The Depth Slopes Are Ratios Of The Normal's Components, So It Needs No Normalizing.
+    const glm::vec3 n = glm::cross(p0 - p1, p1 - p2);
+    // NOTE: Edge-On Polygons Cover No Area On Screen But Would Carry Infinite Depth Slopes.
+    if (!(n.z * n.z > EPS * EPS * glm::dot(n, n))) { continue; }
+    A[pid] = -n.x / n.z;
+    B[pid] = -n.y / n.z;
+    C[pid] = glm::dot(n, p0) / n.z;
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      size_t j = (i + 1) % indices.size();
+
+      glm::vec3 v0 = vertices[indices[i]];
+      glm::vec3 v1 = vertices[indices[j]];
+
+      if (v0.y > v1.y)
       {
-        continue;
+        std::swap(v0, v1);
       }
 
-      if ((*it)->x >= canvas.width || (*nxt)->x < 0)
+      if (!(v0.y < v1.y))
       {
         continue;
       }
 
-      size_t target = polygons.size();
-      float z = INF;
-         
-      for (const auto pid : APT)
-      {
-        float curz = TestZ(pid, (int)std::round(((*it)->x + (*nxt)->x) / 2.0f), y);
-        if (z > curz)
-        {
-          z = curz;
-          target = pid;
-        }
-      }
+      const int ystart = (int)std::ceil(std::clamp(v0.y, 0.0f, (float)canvas.height));
+      const int yend = (int)std::ceil(std::clamp(v1.y, 0.0f, (float)canvas.height));
 
-      if (target != polygons.size())
+      if (ystart >= yend)
       {
-        RenderSegment(*canvas.frame_buffer, std::max(canvas.offsetx + (*it)->x, 0), std::min(canvas.offsetx + (*nxt)->x, canvas.width-1), canvas.offsety + y, polygons[target].color);
+        continue;
       }
+
+      const float dxdy = (v1.x - v0.x) / (v1.y - v0.y);
+      const float xstart = v0.x + ((float)ystart - v0.y) * dxdy;
+      edges.push_back({ystart, yend, xstart, dxdy, xstart, (uint32_t)pid});
     }
-       
-    for (auto& edge : AET)
+  }
+
+  // COMMENT: Counting Sort By ystart. Edges Entering On Row y Are ET[bucket[y], bucket[y + 1]).
+  bucket.resize(canvas.height + 1, 0);
+  for (const auto& edge : edges)
+  {
+    ++bucket[edge.ystart + 1];
+  }
+  for (int y = 0; y < canvas.height; ++y)
+  {
+    bucket[y + 1] += bucket[y];
+  }
+  ET.resize(edges.size());
+  {
+    cursor.assign(bucket.begin(), bucket.end() - 1);
+    for (const auto& edge : edges)
     {
-      edge->ymin += 1;
-      edge->e += edge->m;
-      while(edge->e > 0.0f)
-      {
-        edge->x += edge->d;
-        edge->e -= 1.0f;
-      }
+      ET[cursor[edge.ystart]++] = edge;
+    }
+  }
+
+
+  if (scratches.size() < (size_t)ThreadPool::Concurrency())
+  {
+    scratches.resize(ThreadPool::Concurrency());
+  }
+
+  if (!parallel)
+  {
+    RenderRowsIntervalScanLine(canvas, polygons, table, 0, canvas.height, nullptr, nullptr, scratches[0]);
+    return;
+  }
+
+  static std::vector<int> starts;
+  TileRowBands(canvas, starts);
+  const int bands = (int)starts.size() - 1;
+
+  // COMMENT: Edges Active At A Band's First Row Have ystart < start < yend. ET Is Sorted By ystart, So The First Such Band Only Moves Forward.
+  static std::vector<uint32_t> offsets;  offsets.assign(bands + 1, 0);
+  static std::vector<uint32_t> spanning; spanning.clear();
+  for (size_t e = 0, first = 0; e < ET.size(); ++e)
+  {
+    while ((int)first < bands && starts[first] <= ET[e].ystart) { ++first; }
+    for (int band = (int)first; band < bands && starts[band] < ET[e].yend; ++band)
+    {
+      ++offsets[band + 1];
+    }
+  }
+  for (int band = 0; band < bands; ++band)
+  {
+    offsets[band + 1] += offsets[band];
+  }
+  spanning.resize(offsets[bands]);
+  cursor.assign(offsets.begin(), offsets.end() - 1);
+  for (size_t e = 0, first = 0; e < ET.size(); ++e)
+  {
+    while ((int)first < bands && starts[first] <= ET[e].ystart) { ++first; }
+    for (int band = (int)first; band < bands && starts[band] < ET[e].yend; ++band)
+    {
+      spanning[cursor[band]++] = (uint32_t)e;
     }
   }
+
+  const ThreadPool::Task task = [&](const int band, const int thread) NOEXCEPT
+  {
+    PROFILE_SCOPE(Profiler::RASTERIZE);
+    RenderRowsIntervalScanLine(canvas, polygons, table, starts[band], starts[band + 1], spanning.data() + offsets[band], spanning.data() + offsets[band + 1], scratches[thread]);
+  };
+  ThreadPool::ParallelFor(bands, task);
 }
@@ -17,10 +17,52 @@
 #include <Entity.h>
 #include <Acceleration/HAABB.h>
 
+// COMMENT: Packs A Color Into A Pixel Format Known At Compile Time. Formats Without A Specialization Go Through SDL_MapRGB.
+template<SDL_PixelFormat Format>
+struct PixelWriter;
+
+template<>
+struct PixelWriter<SDL_PIXELFORMAT_XRGB8888>
+{
+  NODISCARD FORCE_INLINE static Uint32 Map(const Uint8 r, const Uint8 g, const Uint8 b) NOEXCEPT
+  {
+    return ((Uint32)r << 16) | ((Uint32)g << 8) | (Uint32)b;
+  }
+};
+
+template<>
+struct PixelWriter<SDL_PIXELFORMAT_ARGB8888>
+{
+  NODISCARD FORCE_INLINE static Uint32 Map(const Uint8 r, const Uint8 g, const Uint8 b) NOEXCEPT
+  {
+    return 0xFF000000u | ((Uint32)r << 16) | ((Uint32)g << 8) | (Uint32)b;
+  }
+};
+
+template<>
+struct PixelWriter<SDL_PIXELFORMAT_ABGR8888>
+{
+  NODISCARD FORCE_INLINE static Uint32 Map(const Uint8 r, const Uint8 g, const Uint8 b) NOEXCEPT
+  {
+    return 0xFF000000u | ((Uint32)b << 16) | ((Uint32)g << 8) | (Uint32)r;
+  }
+};
+
+// COMMENT: Writes Per Pixel That Show As Full Red In The Overdraw Heatmap.
+CONSTEXPR int OVERDRAW_SCALE = 8;
+
 struct Rasterizer
 {
+  NODISCARD FORCE_INLINE static Uint8 Quantize(const float c) NOEXCEPT
+  {
+    return (Uint8)(255.999f * std::clamp(c, 0.0f, 1.0f));
+  }
+
   NODISCARD  static Uint32 MapColor(const FrameBuffer& frame_buffer, const Color& color) NOEXCEPT;
 
+  // COMMENT: Fill mapped_color Of Every Polygon. The Pixel Format Is Resolved Once For The Whole Batch.
+  static void MapColors(const FrameBuffer& frame_buffer, std::vector<Polygon>& polygons) NOEXCEPT;
+
   static void RenderPixel(const FrameBuffer& frame_buffer, int x, int y, Uint32 color) NOEXCEPT;
 
   static void RenderPixel(const FrameBuffer& frame_buffer, int x, int y, const Color& color) NOEXCEPT;
@@ -29,16 +71,66 @@ struct Rasterizer
   
   static void RenderSegment(const FrameBuffer& frame_buffer, int xmin, int xmax, int y, const Color& color) NOEXCEPT;
   
+  // COMMENT: Counters Of The Current Frame. A Span Is Counted Once For Every Coarse Depth Cell It Crosses.
+  // NOTE: written_pixels Counts Every Depth Test That Passed, So Over The Covered Pixels It Is The Overdraw.
+  // COMMENT: Only The ZBuffer Algorithms Count. tested_pixels Are Tested One By One, span_pixels Less tested_pixels Were Settled By Their Cell.
+  // COMMENT: haabb_nodes Are The Nodes Of The HAABB, Or Of A Model's BVH, Taken Off The Stack, And haabb_culled Those Behind The Z Pyramid.
+  struct Statistic
+  {
+    uint64_t span_cells          = {};
+    uint64_t rejected_cells      = {};
+    uint64_t accepted_cells      = {};
+    uint64_t written_pixels      = {};
+    uint64_t spans               = {};
+    uint64_t span_pixels         = {};
+    uint64_t tested_pixels       = {};
+    uint64_t rasterized_polygons = {};
+    uint64_t occluded_polygons   = {};
+    uint64_t haabb_nodes         = {};
+    uint64_t haabb_culled        = {};
+  };
+
+  static Statistic statistic;
+
+  // COMMENT: Writes Per Canvas Pixel, Row By Row. Counted By RenderSpan Only While It Is Not Empty.
+  static std::vector<uint16_t> overdraw;
+
+  // COMMENT: Replace The Canvas With A Heatmap Of overdraw. Black Was Never Written, Blue To Red Goes From Once To OVERDRAW_SCALE Times Or More.
+  static void RenderOverdraw(const Canvas& canvas) NOEXCEPT;
+
+  // COMMENT: Depth Tested Span On Row y Of The Canvas. z Is The Depth At xmin And Steps By dzdx.
+  // NOTE: Pieces Behind A Cell's zmax Are Skipped And Pieces In Front Of Its zmin Are Written Without Per Pixel Tests.
+  static void RenderSpan(const Canvas& canvas, int xmin, int xmax, int y, float z, float dzdx, Uint32 color) NOEXCEPT;
+
   static void RenderTangentDDA(const Canvas& canvas, int x0, int y0, int x1, int y1, const Uint32& color) NOEXCEPT;
   
   static void RenderTangentDDA(const Canvas& canvas, int x0, int y0, int x1, int y1, const Color& color) NOEXCEPT;
 
 
+  // COMMENT: Line In Canvas Coordinates, Already Clipped To The Canvas.
+  struct Line
+  {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    Uint32 color;
+  };
+
+  // COMMENT: Cohen-Sutherland Clip Against The Canvas. Returns false When Nothing Is Left.
+  NODISCARD static bool ClipLine(const Canvas& canvas, float& x0, float& y0, float& x1, float& y1) NOEXCEPT;
+
+  // COMMENT: Draw The Rows [ymin, ymax] Of A Line As Horizontal Runs. Every Run Is Computed Directly From The Endpoints, So Any Row Range Gives The Same Pixels.
+  static void RenderLine(const Canvas& canvas, const Line& line, int ymin, int ymax) NOEXCEPT;
+
   static void RenderTangentBresenham(const Canvas& canvas, int x0, int y0, int x1, int y1, const Uint32& color) NOEXCEPT;
   
   static void RenderTangentBresenham(const Canvas& canvas, int x0, int y0, int x1, int y1, const Color& color) NOEXCEPT;
 
   static void RenderPolygonsWireframe(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT;
+
+  // COMMENT: Draw Each Shared Edge Once. index Maps A Model Polygon To Its Slot In polygons, Or -1 If It Was Culled.
+  static void RenderEdgesWireframe(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const std::vector<uint32_t>& index, const std::vector<Model::Edge>& edges, bool parallel) NOEXCEPT;
   
   struct Edge
   {
@@ -68,14 +160,57 @@ struct Rasterizer
       return ymin == oth.ymin && x == oth.x && d * m == oth.d * oth.m;
     }
   };
-  
+
+  // COMMENT: Edge Of The Interval Scan Line. Covers Rows [ystart, yend) And x Is Evaluated From xstart Every Row, So It Never Drifts.
+  struct ScanEdge
+  {
+    int ystart;
+    int yend;
+    float xstart;
+    float dxdy;
+    float x;
+    uint32_t pid;
+  };
+
+  // COMMENT: Polygon Inside The Current Interval. Its Depth On The Current Row Is a * x + b.
+  struct ActivePolygon
+  {
+    float a;
+    float b;
+    uint32_t pid;
+  };
+
+  // COMMENT: Per Frame Tables Of The Interval Scan Line. Bands Only Read Them.
+  struct ScanLineTable
+  {
+    std::vector<float>    A;
+    std::vector<float>    B;
+    std::vector<float>    C;
+    std::vector<ScanEdge> ET;
+    std::vector<uint32_t> bucket;
+  };
+
+  // COMMENT: Per Thread State Of The Interval Scan Line. Every slot Is Back To -1 After Each Row.
+  struct ScanLineScratch
+  {
+    std::vector<ScanEdge>      AET;
+    std::vector<ActivePolygon> APT;
+    std::vector<int32_t>       slot;
+  };
+
   static void RenderPolygonsScanConvertZBuffer(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT;
   
   static void RenderPolygonsScanConvertHZBuffer(Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT;
   
   static void RenderPolygonsScanConvertHAABBHZBuffer(Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const std::vector<HAABB>& haabbs) NOEXCEPT;
+
+  // COMMENT: Walk A Model's Object Space BVH Near Child First. MVP Takes It To Clip Space, index Maps A Model Polygon To Its Slot In polygons, Or -1.
+  // COMMENT: A Node Is Skipped When Off Screen Or Behind The Z Pyramid. The Canvas Rect Of Every Drawn Leaf Is Appended To rects.
+  // COMMENT: Unless visible Is nullptr, The Leaves It Flags Are Drawn First Without Occlusion Tests, And It Is Rewritten With The Leaves Visible This Frame.
+  static void RenderPolygonsScanConvertBVHHZBuffer(Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, const BVH& bvh, const std::vector<uint32_t>& index, const glm::mat4& MVP, bool clip, std::vector<glm::ivec4>& rects, std::vector<uint8_t>* visible) NOEXCEPT;
   
-  static void RenderPolygonsIntervalScanLine(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons) NOEXCEPT;
+  // COMMENT: With parallel Set, Bands Of Rows Resolve Concurrently On The Thread Pool.
+  static void RenderPolygonsIntervalScanLine(const Canvas& canvas, const std::vector<Vertex>& vertices, const std::vector<Polygon>& polygons, bool parallel) NOEXCEPT;
 };
   
 #endif //RASTERIZER_H
@@ -0,0 +1,293 @@
+/**
+  ******************************************************************************
+  * @file           : RenderThread.cpp
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#include <RenderThread.h>
+#include <Profiler.h>
+
+// COMMENT: Render Thread State. Besides The Handoffs And The Flags, Only The Render Thread Touches It, Or The Main Thread While The Render Thread Is Parked.
+static std::thread thread;
+static std::atomic<bool> running = false;
+static std::atomic<bool> pausing = false;
+static std::atomic<bool> parked  = false;
+
+static TripleBuffer<RenderThread::Snapshot> snapshots;
+static TripleBuffer<RenderThread::Frame> frames;
+
+static SDL_PixelFormat format = {};
+static Color           bgc    = {};
+static ZBuffer         z_buffer;
+static HZBuffer        h_z_buffer;
+static Canvas          canvas;
+
+// COMMENT: Frame Budget Controller State. average Smooths The Render Time At scale, And settle Counts The Frames Left To Only Measure.
+static float  scale   = 1.0f;
+static double average = 0.0;
+static int    settle  = 0;
+
+// COMMENT: The Models Rendered, And For Each The Main Thread's Model It Copies. revision Counts The Times They Were Brought In Line.
+static Scene render_scene;
+static std::vector<const Model*> sources;
+static uint64_t revision = 0;
+
+// COMMENT: Pick The Scale Of The Next Frame From The Render Time Of This One. Render Time Is Taken As Proportional To The Pixels Rendered, So To scale Squared.
+// COMMENT: Over Budget, The Scale Drops At Once To The Step That Should Just Meet It. With Headroom, It Rises One Step At A Time, So It Does Not Overshoot And Swing Back.
+static void Adapt(const Setting& setting, const double time) NOEXCEPT
+{
+  // NOTE: The First Frames At A New Size Also Pay For Allocating It, So They Are Not Trusted.
+  if (settle > 0)
+  {
+    --settle;
+    average = time;
+    return;
+  }
+  average = 0.75 * average + 0.25 * time;
+
+  float next = scale;
+  if (average > (double)setting.frame_budget)
+  {
+    next = std::floor(scale * (float)std::sqrt((double)setting.frame_budget / average) / RENDER_SCALE_STEP) * RENDER_SCALE_STEP;
+  }
+  else if (average < (double)(BUDGET_HEADROOM * setting.frame_budget))
+  {
+    next = (std::floor(scale / RENDER_SCALE_STEP + 0.5f) + 1.0f) * RENDER_SCALE_STEP;
+  }
+  next = std::clamp(next, MIN_RENDER_SCALE, 1.0f);
+  if (next != scale)
+  {
+    scale = next;
+    settle = SCALE_SETTLE;
+  }
+}
+
+// COMMENT: Reallocate frame_buffer, And The Depth Buffers When They Differ Too, To width x height.
+static void Resize(FrameBuffer& frame_buffer, const int width, const int height) NOEXCEPT
+{
+  if (frame_buffer.width != width || frame_buffer.height != height)
+  {
+    FrameBuffer::Destroy(frame_buffer);
+    frame_buffer = FrameBuffer::From(width, height, format, bgc);
+  }
+  if (z_buffer.width != width || z_buffer.height != height)
+  {
+    HZBuffer::Destroy(h_z_buffer);
+    ZBuffer::Destroy(z_buffer);
+
+    z_buffer = ZBuffer::From(frame_buffer, INF);
+
+    canvas.offsetx      = 0;
+    canvas.offsety      = 0;
+    canvas.width        = width;
+    canvas.height       = height;
+    canvas.z_buffer     = &z_buffer;
+
+    h_z_buffer = HZBuffer::From(canvas);
+
+    canvas.h_z_buffer   = &h_z_buffer;
+  }
+}
+
+static void Render(const RenderThread::Snapshot& snapshot) NOEXCEPT
+{
+  size_t i = 0;
+  for (Model& model : render_scene.models)
+  {
+    const RenderThread::Transform& transform = snapshot.transforms[i++];
+    model.scale     = transform.scale;
+    model.rotate    = transform.rotate;
+    model.translate = transform.translate;
+  }
+  render_scene.parallel_lights = snapshot.parallel_lights;
+  render_scene.point_lights    = snapshot.point_lights;
+
+  RenderThread::Frame& frame = TripleBuffer<RenderThread::Frame>::Back(frames);
+  if (!snapshot.setting.dynamic_resolution)
+  {
+    scale = std::clamp(snapshot.setting.render_scale, MIN_RENDER_SCALE, 1.0f);
+    settle = SCALE_SETTLE;
+  }
+  Resize(frame.frame_buffer, std::max((int)std::lround((float)snapshot.width * scale), 1), std::max((int)std::lround((float)snapshot.height * scale), 1));
+  frame.scale = scale;
+  FrameBuffer::Clear(frame.frame_buffer);
+  canvas.frame_buffer = &frame.frame_buffer;
+
+  const auto start_time = std::chrono::high_resolution_clock::now();
+
+  Pipeline::Clear(snapshot.setting, canvas);
+  Pipeline::Render(snapshot.setting, snapshot.config, canvas, snapshot.camera, render_scene);
+
+  const auto end_time = std::chrono::high_resolution_clock::now();
+  frame.time = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+  if (snapshot.setting.dynamic_resolution)
+  {
+    Adapt(snapshot.setting, frame.time);
+  }
+
+  // COMMENT: Reset Stale Tiles Here, So Presenting Is A Plain Copy.
+  // NOTE: Not Timed As Profiler::PRESENT, Which Is The Main Thread's Copy And Display. EndFrame Adds Up The Rows Of Every Thread.
+  FrameBuffer::Display(frame.frame_buffer);
+
+  frame.pipeline   = Pipeline::statistic;
+  frame.rasterizer = Rasterizer::statistic;
+  frame.h_z_buffer = HZBuffer::statistic;
+  frame.visible_pixels.clear();
+  i = 0;
+  for (const Model& model : render_scene.models)
+  {
+    if (const auto query = Pipeline::visible_pixels.find(&model); query != Pipeline::visible_pixels.end())
+    {
+      frame.visible_pixels.emplace(sources[i], query->second);
+    }
+    ++i;
+  }
+
+  PROFILE_END_FRAME();
+#ifdef ENABLE_PROFILER
+  Profiler::Summarize(frame.profiler);
+#endif
+  TripleBuffer<RenderThread::Frame>::Publish(frames);
+}
+
+static void Run() NOEXCEPT
+{
+  while (running.load(std::memory_order_acquire))
+  {
+    if (pausing.load(std::memory_order_acquire))
+    {
+      parked.store(true, std::memory_order_release);
+      while (pausing.load(std::memory_order_acquire))
+      {
+        std::this_thread::yield();
+      }
+      parked.store(false, std::memory_order_release);
+      continue;
+    }
+    if (!TripleBuffer<RenderThread::Snapshot>::Acquire(snapshots))
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    // NOTE: A Snapshot Published Before The Models Last Changed Has Transforms For The Old Ones. The Next Is Never Far Behind.
+    const RenderThread::Snapshot& snapshot = TripleBuffer<RenderThread::Snapshot>::Front(snapshots);
+    if (snapshot.revision == revision)
+    {
+      Render(snapshot);
+    }
+  }
+}
+
+// COMMENT: Copy Loaded Models And Drop Unloaded Ones, With The Render Thread Parked Between Frames.
+// NOTE: Kept Copies Are Spliced, Not Copied, So They Stay At Their Addresses And Pipeline's Caches Keyed By Model Stay Valid.
+static void Sync(const Scene& scene) NOEXCEPT
+{
+  bool same = scene.models.size() == sources.size();
+  auto source = sources.begin();
+  for (auto it = scene.models.begin(); same && it != scene.models.end(); ++it)
+  {
+    same = *source++ == &*it;
+  }
+  if (same)
+  {
+    return;
+  }
+
+  pausing.store(true, std::memory_order_release);
+  while (!parked.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+
+  std::unordered_map<const Model*, std::list<Model>::iterator> copies;
+  source = sources.begin();
+  for (auto it = render_scene.models.begin(); it != render_scene.models.end(); ++it)
+  {
+    copies.emplace(*source++, it);
+  }
+
+  std::list<Model> models;
+  sources.clear();
+  for (const Model& model : scene.models)
+  {
+    if (const auto query = copies.find(&model); query != copies.end())
+    {
+      models.splice(models.end(), render_scene.models, query->second);
+    }
+    else
+    {
+      models.emplace_back(model);
+    }
+    sources.emplace_back(&model);
+  }
+  // NOTE: Copies Left Behind Are Dropped, And A Model Copied In Later Could Take One's Address Before Any Frame Prunes It.
+  for (const Model& model : render_scene.models)
+  {
+    Pipeline::Forget(model);
+  }
+  render_scene.models.swap(models);
+  ++revision;
+
+  // NOTE: Wait For The Render Thread To Leave, Or A Sync Right After Could Take Its Stale parked For A New One.
+  pausing.store(false, std::memory_order_release);
+  while (parked.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+}
+
+void RenderThread::Start(const SDL_PixelFormat frame_format, const Color& frame_bgc) NOEXCEPT
+{
+  format = frame_format;
+  bgc    = frame_bgc;
+
+  running.store(true, std::memory_order_release);
+  thread = std::thread(Run);
+}
+
+void RenderThread::Stop() NOEXCEPT
+{
+  running.store(false, std::memory_order_release);
+  if (thread.joinable())
+  {
+    thread.join();
+  }
+}
+
+void RenderThread::Publish(const int width, const int height, const Setting& setting, const Shader::Config& config, const Camera& camera, const Scene& scene) NOEXCEPT
+{
+  Sync(scene);
+
+  Snapshot& snapshot = TripleBuffer<Snapshot>::Back(snapshots);
+  snapshot.width           = width;
+  snapshot.height          = height;
+  snapshot.setting         = setting;
+  snapshot.config          = config;
+  snapshot.camera          = camera;
+  snapshot.parallel_lights = scene.parallel_lights;
+  snapshot.point_lights    = scene.point_lights;
+  snapshot.transforms.clear();
+  for (const Model& model : scene.models)
+  {
+    snapshot.transforms.emplace_back(Transform{ .scale = model.scale, .rotate = model.rotate, .translate = model.translate });
+  }
+  snapshot.revision = revision;
+
+  TripleBuffer<Snapshot>::Publish(snapshots);
+}
+
+NODISCARD bool RenderThread::Acquire() NOEXCEPT
+{
+  return TripleBuffer<Frame>::Acquire(frames);
+}
+
+NODISCARD const RenderThread::Frame& RenderThread::Front() NOEXCEPT
+{
+  return TripleBuffer<Frame>::Front(frames);
+}
@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file           : RenderThread.h
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include <Common.h>
+#include <Entity.h>
+#include <Shader.h>
+#include <Pipeline.h>
+#include <Rasterizer.h>
+#include <Parallel.h>
+#include <Profiler.h>
+#include <Acceleration/HZBuffer.h>
+
+// COMMENT: Render Scales The Frame Budget Controller Moves Between, In Steps Of RENDER_SCALE_STEP.
+// COMMENT: It Steps Up Once Render Time Falls Under BUDGET_HEADROOM Of The Budget, And Only Measures For SCALE_SETTLE Frames After Any Change.
+CONSTEXPR float MIN_RENDER_SCALE  = 0.25f;
+CONSTEXPR float RENDER_SCALE_STEP = 1.0f / 16.0f;
+CONSTEXPR float BUDGET_HEADROOM   = 0.7f;
+CONSTEXPR int   SCALE_SETTLE      = 4;
+
+// COMMENT: Render Thread System. Pipeline::Render Runs On A Thread Of Its Own, So The Main Thread Polls Events, Draws The Controller And Presents Without Waiting On It.
+// COMMENT: The Main Thread Publishes A Snapshot Each Frame And The Render Thread Publishes Each Finished Frame, Both Through A TripleBuffer.
+// NOTE: The Render Thread Keeps Its Own Copy Of The Models. Only Their Transforms Travel In A Snapshot, And Geometry Is Copied Once, By Sync, When A Model Is Loaded.
+struct RenderThread
+{
+  struct Transform
+  {
+    glm::vec3 scale     = {};
+    glm::vec3 rotate    = {};
+    glm::vec3 translate = {};
+  };
+
+  // COMMENT: Everything A Frame Reads That The Main Thread May Change. transforms Follows The Order Of Scene::models. width And height Are The Window's, Before Scaling.
+  struct Snapshot
+  {
+    int width                                = {};
+    int height                               = {};
+    Setting setting                          = {};
+    Shader::Config config                    = {};
+    Camera camera                            = {};
+    std::list<ParallelLight> parallel_lights = {};
+    std::list<PointLight> point_lights       = {};
+    std::vector<Transform> transforms        = {};
+    uint64_t revision                        = {};
+  };
+
+  // COMMENT: A Finished Frame, With The Statistics Left By Rendering It. time Is In Milliseconds And Covers Clearing And Pipeline::Render.
+  // NOTE: frame_buffer Is scale Times The Window Size, Which Every Slot Follows On Its Own, So The One Being Presented Is Never Reallocated.
+  // NOTE: visible_pixels Is Keyed By The Models Of The Main Thread's Scene, Like Pipeline::visible_pixels Is By The Rendered Ones.
+  // NOTE: profiler Is Taken After The Frame Ended, So Its History Includes It. The Live Profiler History Belongs To The Render Thread.
+  struct Frame
+  {
+    FrameBuffer frame_buffer                                  = {};
+    float scale                                               = {};
+    double time                                               = {};
+    Pipeline::Statistic pipeline                              = {};
+    Rasterizer::Statistic rasterizer                          = {};
+    HZBuffer::Statistic h_z_buffer                            = {};
+    std::unordered_map<const Model*, uint64_t> visible_pixels = {};
+#ifdef ENABLE_PROFILER
+    Profiler::Summary profiler                                = {};
+#endif
+  };
+
+  // COMMENT: Start The Render Thread. Frames Are In format, Over bgc. Buffers Are Allocated With The First Frame, And Again Whenever Its Size Changes.
+  static void Start(SDL_PixelFormat format, const Color& bgc) NOEXCEPT;
+
+  static void Stop() NOEXCEPT;
+
+  // COMMENT: Bring The Render Thread's Models In Line With scene When Models Were Loaded Or Unloaded, Then Publish A Snapshot Of Everything Else.
+  // NOTE: Models Are Matched By Address. Changing Which Models There Are Waits For The Frame Being Rendered, Since Only Then Are The Copies Free To Change.
+  static void Publish(int width, int height, const Setting& setting, const Shader::Config& config, const Camera& camera, const Scene& scene) NOEXCEPT;
+
+  // COMMENT: Take The Latest Finished Frame. Returns false, Keeping The Last One, When None Finished Since.
+  NODISCARD static bool Acquire() NOEXCEPT;
+
+  // COMMENT: The Frame Last Taken By Acquire. Before The First, Its frame_buffer Is Empty And Its Statistics Are 0.
+  // NOTE: Main Thread Only, Like Acquire And Publish.
+  NODISCARD static const Frame& Front() NOEXCEPT;
+};
+
+#endif //RENDERTHREAD_H
@@ -80,3 +80,36 @@ NODISCARD  glm::mat4 Transformer::Viewport(const Canvas& canvas) NOEXCEPT
     aabb.vmax += glm::max(a, b);
   }
 }
+
+NODISCARD  bool Transformer::ProjectAABB(const Canvas& canvas, const glm::mat4& MVP, const AABB& aabb, const bool clip, glm::ivec4& rect, float& znear) NOEXCEPT
+{
+  // NOTE: The Viewport Leaves w Alone, So It Can Be Applied Before The Divide.
+  const glm::mat4 matrix = Viewport(canvas) * MVP;
+
+  Vertex vmin(INF), vmax(-INF);
+  for (int i = 0; i < 8; ++i)
+  {
+    const glm::vec4 corner((i & 1) ? aabb.vmax.x : aabb.vmin.x, (i & 2) ? aabb.vmax.y : aabb.vmin.y, (i & 4) ? aabb.vmax.z : aabb.vmin.z, 1.0f);
+    const glm::vec4 t = matrix * corner;
+    if (t.w <= 0.0f)
+    {
+      rect = glm::ivec4(0, canvas.width - 1, 0, canvas.height - 1);
+      znear = -INF;
+      return true;
+    }
+    vmin = glm::min(vmin, t.xyz() / t.w);
+    vmax = glm::max(vmax, t.xyz() / t.w);
+  }
+
+  if (clip && (vmax.z < -1.0f || vmin.z > 1.0f))
+  {
+    return false;
+  }
+
+  rect.x = std::max((int)std::floor(vmin.x) - 1, 0);
+  rect.y = std::min((int)std::ceil(vmax.x) + 1, canvas.width - 1);
+  rect.z = std::max((int)std::floor(vmin.y) - 1, 0);
+  rect.w = std::min((int)std::ceil(vmax.y) + 1, canvas.height - 1);
+  znear = vmin.z;
+  return rect.x <= rect.y && rect.z <= rect.w;
+}
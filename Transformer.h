@@ -39,6 +39,11 @@ struct Transformer
   NODISCARD  static glm::mat4 Viewport(const Canvas& canvas) NOEXCEPT;
   
    static void TransformAABB(AABB& aabb, const glm::mat4& matrix) NOEXCEPT;
+
+  // COMMENT: Canvas Rect [rect.x, rect.y] x [rect.z, rect.w] And Nearest Depth Of A Box Under MVP. Returns false When No Part Of The Box Is On Screen.
+  // NOTE: The Rect Grows By One Pixel, Since Polygons Reach Their Pixels Through A Different Chain Of Transforms Than The Box.
+  // NOTE: A Box Reaching Behind The Eye Has No Usable Projection, So It Covers The Whole Canvas And Is Never Occluded.
+  NODISCARD  static bool ProjectAABB(const Canvas& canvas, const glm::mat4& MVP, const AABB& aabb, bool clip, glm::ivec4& rect, float& znear) NOEXCEPT;
   
 };
 
@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file           : Writer.cpp
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#include <Writer.h>
+
+// COMMENT: Stored Deflate Blocks Hold At Most This Many Bytes.
+CONSTEXPR size_t STORED_BLOCK = 65535;
+
+// COMMENT: The Frame As Packed 8 Bit RGB Rows, Each Led By prefix Bytes Of 0.
+static void Unpack(const FrameBuffer& frame_buffer, const int prefix, std::vector<uint8_t>& bytes) NOEXCEPT
+{
+  bytes.clear();
+  bytes.reserve((size_t)frame_buffer.height * (prefix + 3 * frame_buffer.width));
+  for (int y = 0; y < frame_buffer.height; ++y)
+  {
+    bytes.insert(bytes.end(), prefix, 0);
+    for (int x = 0; x < frame_buffer.width; ++x)
+    {
+      Uint8 r, g, b;
+      SDL_GetRGB(FrameBuffer::Pixel(frame_buffer, x, y), frame_buffer.format, nullptr, &r, &g, &b);
+      bytes.emplace_back(r);
+      bytes.emplace_back(g);
+      bytes.emplace_back(b);
+    }
+  }
+}
+
+NODISCARD static uint32_t CRC(const uint8_t* data, const size_t size, uint32_t crc = 0) NOEXCEPT
+{
+  static uint32_t table[256] = {};
+  if (table[1] == 0)
+  {
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k)
+      {
+        c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      table[n] = c;
+    }
+  }
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+static void PutU32(std::vector<uint8_t>& bytes, const uint32_t v) NOEXCEPT
+{
+  bytes.emplace_back((uint8_t)(v >> 24));
+  bytes.emplace_back((uint8_t)(v >> 16));
+  bytes.emplace_back((uint8_t)(v >> 8));
+  bytes.emplace_back((uint8_t)v);
+}
+
+// COMMENT: Append A Chunk: Length, Type, Data And The CRC Of Type And Data.
+static void PutChunk(std::vector<uint8_t>& bytes, const char* type, const std::vector<uint8_t>& data) NOEXCEPT
+{
+  PutU32(bytes, (uint32_t)data.size());
+  const size_t start = bytes.size();
+  bytes.insert(bytes.end(), type, type + 4);
+  bytes.insert(bytes.end(), data.begin(), data.end());
+  PutU32(bytes, CRC(bytes.data() + start, bytes.size() - start));
+}
+
+NODISCARD static Writer::Result WriteFile(const char* filename, const uint8_t* data, const size_t size) NOEXCEPT
+{
+  FILE* fp = fopen(filename, "wb");
+  if (fp == nullptr)
+  {
+    return Writer::ERROR_OPEN_FILE;
+  }
+  if (fwrite(data, 1, size, fp) != size)
+  {
+    fclose(fp);
+    return Writer::ERROR_WRITE_FILE;
+  }
+  if (fclose(fp) != 0)
+  {
+    return Writer::ERROR_CLOSE_FILE;
+  }
+  return Writer::SUCCESS;
+}
+
+ Writer::Result Writer::SavePPM(const char* filename, const FrameBuffer& frame_buffer) NOEXCEPT
+{
+  static std::vector<uint8_t> pixels;
+  Unpack(frame_buffer, 0, pixels);
+
+  const std::string header = fmt::sprintf("P6\n%d %d\n255\n", frame_buffer.width, frame_buffer.height);
+  static std::vector<uint8_t> bytes;
+  bytes.assign(header.begin(), header.end());
+  bytes.insert(bytes.end(), pixels.begin(), pixels.end());
+  return WriteFile(filename, bytes.data(), bytes.size());
+}
+
+ Writer::Result Writer::SavePNG(const char* filename, const FrameBuffer& frame_buffer) NOEXCEPT
+{
+  // COMMENT: Every Row Starts With Filter Type 0, None.
+  static std::vector<uint8_t> pixels;
+  Unpack(frame_buffer, 1, pixels);
+
+  // COMMENT: zlib Stream Of Stored Blocks, Closed By The Adler-32 Of The Raw Bytes.
+  static std::vector<uint8_t> stream;
+  stream.clear();
+  stream.reserve(pixels.size() + pixels.size() / STORED_BLOCK * 5 + 16);
+  stream.emplace_back(0x78);
+  stream.emplace_back(0x01);
+  size_t offset = 0;
+  do
+  {
+    const size_t size = std::min(STORED_BLOCK, pixels.size() - offset);
+    stream.emplace_back(offset + size == pixels.size() ? 1 : 0);
+    stream.emplace_back((uint8_t)size);
+    stream.emplace_back((uint8_t)(size >> 8));
+    stream.emplace_back((uint8_t)~size);
+    stream.emplace_back((uint8_t)(~size >> 8));
+    stream.insert(stream.end(), pixels.begin() + offset, pixels.begin() + offset + size);
+    offset += size;
+  } while (offset < pixels.size());
+  uint32_t a = 1, b = 0;
+  for (const uint8_t byte : pixels)
+  {
+    a = (a + byte) % 65521u;
+    b = (b + a) % 65521u;
+  }
+  PutU32(stream, (b << 16) | a);
+
+  static std::vector<uint8_t> bytes;
+  bytes.clear();
+  bytes.reserve(stream.size() + 64);
+  const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  bytes.insert(bytes.end(), signature, signature + 8);
+
+  // COMMENT: Width, Height, 8 Bits, Truecolor, Deflate, Adaptive Filtering, No Interlace.
+  std::vector<uint8_t> header;
+  PutU32(header, (uint32_t)frame_buffer.width);
+  PutU32(header, (uint32_t)frame_buffer.height);
+  header.insert(header.end(), { 8, 2, 0, 0, 0 });
+
+  PutChunk(bytes, "IHDR", header);
+  PutChunk(bytes, "IDAT", stream);
+  PutChunk(bytes, "IEND", {});
+  return WriteFile(filename, bytes.data(), bytes.size());
+}
+
+ Writer::Result Writer::Save(const char* filename, const FrameBuffer& frame_buffer) NOEXCEPT
+{
+  const std::string extension = std::filesystem::path(filename).extension().string();
+  if (extension == ".ppm" || extension == ".PPM")
+  {
+    return SavePPM(filename, frame_buffer);
+  }
+  if (extension == ".png" || extension == ".PNG")
+  {
+    return SavePNG(filename, frame_buffer);
+  }
+  return ERROR_UNKNOWN_FORMAT;
+}
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file           : Writer.h
+  * @author         : AliceRemake
+  * @brief          : None
+  * @attention      : None
+  * @date           : 24-12-9
+  ******************************************************************************
+  */
+
+
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <Common.h>
+#include <Entity.h>
+
+// COMMENT: Writer System. For Saving Frames To Image Files.
+// Ref: https://netpbm.sourceforge.net/doc/ppm.html
+// Ref: https://www.w3.org/TR/png/
+struct Writer
+{
+  enum Result
+  {
+    SUCCESS,
+    ERROR_OPEN_FILE,
+    ERROR_CLOSE_FILE,
+    ERROR_WRITE_FILE,
+    ERROR_UNKNOWN_FORMAT,
+  };
+
+  // COMMENT: Binary PPM, 8 Bits Per Channel.
+   static Result SavePPM(const char* filename, const FrameBuffer& frame_buffer) NOEXCEPT;
+
+  // COMMENT: 8 Bit RGB PNG. Pixels Are Stored Without Compression, So No Deflate Library Is Needed.
+   static Result SavePNG(const char* filename, const FrameBuffer& frame_buffer) NOEXCEPT;
+
+  // COMMENT: Pick The Format From The Extension Of filename, .ppm Or .png.
+   static Result Save(const char* filename, const FrameBuffer& frame_buffer) NOEXCEPT;
+};
+
+#endif //WRITER_H
@@ -3,7 +3,14 @@
 #include <Pipeline.h>
 #include <Actor.h>
 #include <Controller.h>
+#include <Parallel.h>
+#include <Acceleration/HZBuffer.h>
+#include <Loader.h>
+#include <Writer.h>
+#include <Profiler.h>
+#include <RenderThread.h>
 
+// COMMENT: Default Size Of The Renderer Window, Or Of The Frame In Headless Mode.
 CONSTEXPR int RENDERER_WIDTH = 1024;
 CONSTEXPR int RENDERER_HEIGHT = 1024;
 
@@ -14,6 +21,7 @@ Setting setting;
 Shader::Config config;
 FrameBuffer frame_buffer;
 ZBuffer z_buffer;
+HZBuffer h_z_buffer;
 Canvas canvas;
 Camera camera;
 Scene scene;
@@ -22,58 +30,254 @@ ParallelLight* selected_parallel_light;
 PointLight* selected_point_light;
 size_t frame_time;
 
-int main(const int argc, char** argv)
+// COMMENT: Command Line Options. Headless Mode Renders frames Frames Without Any Window Or ImGui, Then Saves The Last One To output.
+// NOTE: An output Containing A printf Style Integer Such As frame_%03d.png Saves Every Frame Instead.
+struct Options
 {
-  (void)argc; (void)argv;
-  
-  if (!SDL_Init(SDL_INIT_VIDEO))
+  bool headless = false;
+  int frames = 1;
+  const char* output = "frame.ppm";
+  int algorithm = Setting::ScanConvertZBuffer;
+  std::vector<const char*> models = {};
+  const char* trace = nullptr;
+  int trace_frames = 30;
+  int width = RENDERER_WIDTH;
+  int height = RENDERER_HEIGHT;
+};
+
+static void Usage() NOEXCEPT
+{
+  fmt::printf(
+    "Usage: SoftwareRenderer [--headless] [--frames N] [--output FILE.ppm|FILE.png] [--algorithm 0-4] [--model FILE.obj]... [--trace FILE.json] [--trace-frames N] [--width N] [--height N]\n"
+    "  --headless   Render Without A Window, Then Write The Frame To --output.\n"
+    "  --frames     Frames To Render In Headless Mode. Default 1.\n"
+    "  --output     Image To Write, .ppm Or .png. Default frame.ppm. With One %d Or %0Nd, Such As frame_%03d.png, Every Frame Is Written.\n"
+    "  --algorithm  Setting::Algorithm To Use. Default 0.\n"
+    "  --model      Obj Model To Load. May Be Given More Than Once.\n"
+    "  --trace      Capture A Chrome Trace Of The Frames After The First To FILE.json. Needs The Profiler Build.\n"
+    "  --trace-frames  Frames To Capture With --trace. Default 30.\n"
+    "  --width      Width Of The Window, Or Of The Frame In Headless Mode. Default 1024.\n"
+    "  --height     Height Of The Window, Or Of The Frame In Headless Mode. Default 1024.\n"
+  );
+}
+
+// COMMENT: Whether pattern Holds Exactly One Integer Conversion, %d Or %0Nd, Besides Any Literal %%.
+// NOTE: fmt::sprintf Reports A Bad Format Only By Throwing, Which Aborts A Build Without Exceptions, So Patterns Are Checked Up Front.
+NODISCARD static bool IsFramePattern(const char* pattern) NOEXCEPT
+{
+  int conversions = 0;
+  for (const char* c = pattern; *c != '\0'; ++c)
   {
-    Fatal("Can Not Init SDL!\n");
+    if (*c != '%')
+    {
+      continue;
+    }
+    if (*++c == '%')
+    {
+      continue;
+    }
+    if (*c == '0')
+    {
+      ++c;
+      while ('0' <= *c && *c <= '9')
+      {
+        ++c;
+      }
+    }
+    if (*c != 'd')
+    {
+      return false;
+    }
+    ++conversions;
   }
+  return conversions == 1;
+}
 
-  SDL_Window* renderer_window = SDL_CreateWindow("Renderer", RENDERER_WIDTH, RENDERER_HEIGHT,  SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_HIDDEN);
-  if (renderer_window == nullptr)
+NODISCARD static Options Parse(const int argc, char** argv) NOEXCEPT
+{
+  Options options;
+  for (int i = 1; i < argc; ++i)
   {
-    Fatal("Can Not Create cWindow! %s\n", SDL_GetError());
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--headless")
+    {
+      options.headless = true;
+    }
+    else if (arg == "--frames" && has_value)
+    {
+      options.frames = std::max(atoi(argv[++i]), 1);
+    }
+    else if (arg == "--output" && has_value)
+    {
+      options.output = argv[++i];
+      if (std::string(options.output).find('%') != std::string::npos && !IsFramePattern(options.output))
+      {
+        Usage();
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (arg == "--algorithm" && has_value)
+    {
+      options.algorithm = atoi(argv[++i]);
+      if (options.algorithm < Setting::ScanConvertZBuffer || options.algorithm > Setting::ScanConvertBVHHZBuffer)
+      {
+        Fatal("Unsupported Algorithm %d", options.algorithm);
+      }
+    }
+    else if (arg == "--model" && has_value)
+    {
+      options.models.emplace_back(argv[++i]);
+    }
+    else if (arg == "--trace" && has_value)
+    {
+      options.trace = argv[++i];
+    }
+    else if (arg == "--trace-frames" && has_value)
+    {
+      options.trace_frames = std::max(atoi(argv[++i]), 1);
+    }
+    else if (arg == "--width" && has_value)
+    {
+      options.width = std::max(atoi(argv[++i]), 1);
+    }
+    else if (arg == "--height" && has_value)
+    {
+      options.height = std::max(atoi(argv[++i]), 1);
+    }
+    else
+    {
+      Usage();
+      exit(arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
   }
+  return options;
+}
 
-  SDL_Window* controller_window = SDL_CreateWindow("Controller", CONTROLLER_WIDTH, CONTROLLER_HEIGHT, SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_HIDDEN);
-  if (controller_window == nullptr)
+// COMMENT: Headless Main Loop. Nothing Here Touches A Display, So It Runs Where No Video Device Exists.
+static void RunHeadless(const Options& options) NOEXCEPT
+{
+  const bool every = std::string(options.output).find('%') != std::string::npos;
+  double total_time = 0.0;
+  for (int frame = 0; frame < options.frames; ++frame)
   {
-    Fatal("Can Not Create Controller Window! %s\n", SDL_GetError());
+    FrameBuffer::Clear(frame_buffer);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    Pipeline::Clear(setting, canvas);
+    Actor::OnUpdate(camera);
+    Pipeline::Render(setting, config, canvas, camera, scene);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    total_time += std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+    {
+      PROFILE_SCOPE(Profiler::PRESENT);
+      FrameBuffer::Display(frame_buffer);
+    }
+    PROFILE_END_FRAME();
+
+    if (every || frame + 1 == options.frames)
+    {
+      const std::string filename = every ? fmt::sprintf(options.output, frame) : std::string(options.output);
+      if (Writer::Save(filename.c_str(), frame_buffer) != Writer::SUCCESS)
+      {
+        Fatal("Can Not Write %s", filename);
+      }
+    }
   }
-  
-  SDL_Renderer* controller_renderer = SDL_CreateRenderer(controller_window, nullptr);
-  if (controller_renderer == nullptr)
+  Info("Rendered %d Frames, %.3f ms Per Frame", options.frames, total_time / options.frames);
+}
+
+int main(const int argc, char** argv)
+{
+  const Options options = Parse(argc, argv);
+
+  SDL_Window* renderer_window = nullptr;
+  SDL_Window* controller_window = nullptr;
+  SDL_Renderer* controller_renderer = nullptr;
+
+  if (!options.headless)
   {
-    Fatal("Can Not Create Renderer! %s\n", SDL_GetError());
+    if (!SDL_Init(SDL_INIT_VIDEO))
+    {
+      Fatal("Can Not Init SDL!\n");
+    }
+
+    renderer_window = SDL_CreateWindow("Renderer", options.width, options.height, SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_HIDDEN);
+    if (renderer_window == nullptr)
+    {
+      Fatal("Can Not Create cWindow! %s\n", SDL_GetError());
+    }
+
+    controller_window = SDL_CreateWindow("Controller", CONTROLLER_WIDTH, CONTROLLER_HEIGHT, SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_HIDDEN);
+    if (controller_window == nullptr)
+    {
+      Fatal("Can Not Create Controller Window! %s\n", SDL_GetError());
+    }
+    
+    controller_renderer = SDL_CreateRenderer(controller_window, nullptr);
+    if (controller_renderer == nullptr)
+    {
+      Fatal("Can Not Create Renderer! %s\n", SDL_GetError());
+    }
+
+    // NOTE: Rendering No Longer Holds The Main Loop Back, So The Display Paces It Instead.
+    if (!SDL_SetRenderVSync(controller_renderer, 1))
+    {
+      Warn("Can Not Enable VSync! %s", SDL_GetError());
+    }
   }
 
-  setting.show_aabb     = false;
-  setting.show_normal   = false;
-  setting.show_z_buffer = false;
-  setting.enable_cull   = true;
-  setting.enable_clip   = true;
-  setting.algorithm     = Setting::ScanConvertZBuffer;
-  setting.display_mode  = Setting::NORMAL;
+  setting.show_aabb          = false;
+  setting.show_normal        = false;
+  setting.show_z_buffer      = false;
+  setting.show_overdraw      = false;
+  setting.count_overdraw     = false;
+  setting.enable_cull        = true;
+  setting.enable_clip        = true;
+  setting.enable_parallel    = false;
+  setting.screen_haabb       = false;
+  setting.enable_sort        = false;
+  setting.temporal_culling   = false;
+  setting.occlusion_prepass  = false;
+  setting.algorithm          = (Setting::Algorithm)options.algorithm;
+  setting.display_mode       = Setting::NORMAL;
+  setting.update_policy      = Setting::IMMEDIATE;
+  setting.batch_size         = 64;
+  setting.render_scale       = 1.0f;
+  setting.dynamic_resolution = false;
+  setting.frame_budget       = 16.7f;
+  setting.upscale_filter     = Setting::BILINEAR;
 
   config.ka = 0.1f;
   config.kd = 0.5f;
   config.ks = 0.4f;
   config.ps = 2.5f;
   
-  frame_buffer     = FrameBuffer::From(renderer_window, Color(0.0f, 0.0f, 0.0f));
-  frame_buffer.bgc = Color(0.70f, 0.60f, 0.80f);
+  // COMMENT: Headless Mode Renders Straight Into frame_buffer. Otherwise It Is The Window, And The Render Thread Draws To Buffers Of Its Own In The Window's Format.
+  if (options.headless)
+  {
+    frame_buffer = FrameBuffer::From(options.width, options.height, SDL_PIXELFORMAT_XRGB8888, Color(0.70f, 0.60f, 0.80f));
+
+    z_buffer = ZBuffer::From(frame_buffer, INF);
+
+    canvas.offsetx      = 0;
+    canvas.offsety      = 0;
+    canvas.width        = frame_buffer.width;
+    canvas.height       = frame_buffer.height;
+    canvas.frame_buffer = &frame_buffer;
+    canvas.z_buffer     = &z_buffer;
 
-  z_buffer = ZBuffer::From(frame_buffer, INF);
+    h_z_buffer = HZBuffer::From(canvas);
 
-  canvas.offsetx      = 0;
-  canvas.offsety      = 0;
-  canvas.width        = RENDERER_WIDTH;
-  canvas.height       = RENDERER_HEIGHT;
-  canvas.frame_buffer = &frame_buffer;
-  canvas.z_buffer     = &z_buffer;
-  canvas.zbh_tree   = ZBH::From(canvas);
+    canvas.h_z_buffer   = &h_z_buffer;
+  }
+  else
+  {
+    frame_buffer = FrameBuffer::From(renderer_window, Color(0.70f, 0.60f, 0.80f));
+  }
 
   camera.position  = Vertex(0.0f, 0.0f, 2.0f);
   camera.direction = Vector(0.0f, 0.0f, -1.0f);
@@ -82,7 +286,7 @@ int main(const int argc, char** argv)
   camera.yaw       = glm::radians(180.0f);
   camera.pitch     = 0.0f;
   camera.fov       = glm::radians(75.0f);
-  camera.aspect    = (float)RENDERER_WIDTH / (float)RENDERER_HEIGHT;
+  camera.aspect    = (float)frame_buffer.width / (float)frame_buffer.height;
   camera.near      = 0.1f;
   camera.far       = 100.0f;
 
@@ -136,15 +340,44 @@ int main(const int argc, char** argv)
   scene.point_lights.emplace_back(point_light_0);
   scene.point_lights.emplace_back(point_light_1);
 
-  selected_model = &scene.models.front();
+  for (const char* filename : options.models)
+  {
+    Model model;
+    if (Loader::LoadObj(filename, model) != Loader::SUCCESS)
+    {
+      Fatal("Can Not Load Model %s", filename);
+    }
+    scene.models.emplace_back(std::move(model));
+  }
+
+  selected_model = scene.models.empty() ? nullptr : &scene.models.front();
   selected_parallel_light = &scene.parallel_lights.front();
   selected_point_light = &scene.point_lights.front();
+
+  if (options.trace != nullptr)
+  {
+#ifdef ENABLE_PROFILER
+    // NOTE: A Capture Starts At A Frame Boundary, So The First Frame Is Never Captured.
+    Profiler::Capture(options.trace_frames, options.trace);
+#else
+    Warn("Built Without The Profiler, --trace Is Ignored");
+#endif
+  }
+
+  if (options.headless)
+  {
+    RunHeadless(options);
+    ThreadPool::ShutDown();
+    return 0;
+  }
   
   Controller::SetUp(controller_window, controller_renderer);
+
+  RenderThread::Start(frame_buffer.surface->format, frame_buffer.bgc);
   
   SDL_SetWindowPosition(renderer_window, 0, 100);
   SDL_ShowWindow(renderer_window);
-  SDL_SetWindowPosition(controller_window, RENDERER_WIDTH, 100);
+  SDL_SetWindowPosition(controller_window, options.width, 100);
   SDL_ShowWindow(controller_window);
   
   bool running = true;
@@ -165,6 +398,19 @@ int main(const int argc, char** argv)
       }
       if (event.window.windowID == SDL_GetWindowID(renderer_window))
       {
+        // NOTE: Display Only Updates What Changed, So Whatever Was Uncovered Is Refreshed From The Surface Here.
+        if (event.type == SDL_EVENT_WINDOW_EXPOSED)
+        {
+          SDL_UpdateWindowSurface(renderer_window);
+        }
+        // NOTE: Resizing Replaces The Window Surface. Frames Of The Old Size Still In Flight Are Just Scaled To The New One.
+        if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED)
+        {
+          const Color bgc = frame_buffer.bgc;
+          FrameBuffer::Destroy(frame_buffer);
+          frame_buffer = FrameBuffer::From(renderer_window, bgc);
+          camera.aspect = (float)frame_buffer.width / (float)frame_buffer.height;
+        }
         if (selected_model != nullptr)
         {
           Actor::OnEvent(*selected_model, &event);
@@ -179,44 +425,36 @@ int main(const int argc, char** argv)
       continue;
     }
 
-    FrameBuffer::Clear(frame_buffer);
-
-    // COMMENT: Begin Render. 
-
-    auto start_time = std::chrono::high_resolution_clock::now();
-    
-    switch (setting.algorithm)
-    {
-      case Setting::ScanConvertZBuffer:
-        ZBuffer::Clear(z_buffer);
-      break;
-      case Setting::ScanConvertHZBuffer: 
-      case Setting::ScanConvertHAABBHZBuffer:
-        ZBuffer::Clear(z_buffer);
-        ZBH::Clear(canvas.zbh_tree, canvas);
-      break;
-      case Setting::IntervalScanLine: 
-      break;
-      default:
-        Fatal("Unsupported Algorithm");
-    }
-
     Controller::OnUpdate(controller_renderer);
     Actor::OnUpdate(camera);
 
-    Pipeline::Render(setting, config, canvas, camera, scene);
-
-    auto end_time = std::chrono::high_resolution_clock::now();
-
-    frame_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    RenderThread::Publish(frame_buffer.width, frame_buffer.height, setting, config, camera, scene);
 
-    // COMMENT: End Render. 
-
-    FrameBuffer::Display(frame_buffer);
+    // COMMENT: Present The Latest Frame The Render Thread Finished, If Any Finished Since The Last. frame_time Is Its Render Time.
+    if (RenderThread::Acquire())
+    {
+      PROFILE_SCOPE(Profiler::PRESENT);
+      const RenderThread::Frame& frame = RenderThread::Front();
+      FrameBuffer::Clear(frame_buffer);
+      if (frame.frame_buffer.width == frame_buffer.width && frame.frame_buffer.height == frame_buffer.height)
+      {
+        FrameBuffer::Copy(frame_buffer, frame.frame_buffer);
+      }
+      else
+      {
+        FrameBuffer::Upscale(frame_buffer, frame.frame_buffer, setting.upscale_filter == Setting::BILINEAR);
+      }
+      FrameBuffer::Display(frame_buffer);
+      frame_time = (size_t)frame.time;
+    }
   }
 
+  RenderThread::Stop();
+
   Controller::ShutDown();
 
+  ThreadPool::ShutDown();
+
   SDL_Quit();
 
   return 0;